@@ -11,5 +11,8 @@ public class AuraTarget : TargetRules
 		DefaultBuildSettings = BuildSettingsVersion.V5;
 
 		ExtraModuleNames.AddRange( new string[] { "Aura" } );
+
+		// UAuraAttributeSet replicates with the push model
+		bWithPushModel = true;
 	}
 }
@@ -3,7 +3,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("Aura"), STATGROUP_Aura, STATCAT_Advanced);
 
 #define CUSTOM_DEPTH_RED 250
 #define ECC_Projectile ECollisionChannel::ECC_GameTraceChannel1
+#define ECC_Combat ECollisionChannel::ECC_GameTraceChannel2
 
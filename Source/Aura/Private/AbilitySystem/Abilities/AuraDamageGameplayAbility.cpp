@@ -3,3 +3,19 @@
 
 #include "AbilitySystem/Abilities/AuraDamageGameplayAbility.h"
 
+#include "AbilitySystem/AuraAbilitySystemComponent.h"
+
+#if WITH_EDITOR
+void UAuraDamageGameplayAbility::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// The spec templates were built from these
+	const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UAuraDamageGameplayAbility, DamageEffectClass) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(UAuraDamageGameplayAbility, DamageTypes))
+	{
+		UAuraAbilitySystemComponent::InvalidateAllSpecTemplates();
+	}
+}
+#endif
@@ -5,10 +5,31 @@
 
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
+#include "Aura.h"
+#include "AbilitySystem/AuraAbilitySystemComponent.h"
+#include "AbilitySystem/AuraAbilitySystemLibrary.h"
 #include "Actor/AuraProjectile.h"
+#include "Actor/AuraProjectilePoolSubsystem.h"
 #include "Aura/Public/AuraGameplayTags.h"
+#include "Character/AuraCharacterBase.h"
 #include "Interaction/CombatInterface.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Damage Specs Built"), STAT_AuraProjectileDamageSpecsBuilt, STATGROUP_Aura);
+
+void UAuraProjectileSpell::OnGiveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec)
+{
+	Super::OnGiveAbility(ActorInfo, Spec);
+
+	const AActor* AvatarActor = ActorInfo ? ActorInfo->AvatarActor.Get() : nullptr;
+	if (AvatarActor && AvatarActor->HasAuthority() && NumPrewarmedProjectiles > 0)
+	{
+		if (UAuraProjectilePoolSubsystem* ProjectilePool = AvatarActor->GetWorld()->GetSubsystem<UAuraProjectilePoolSubsystem>())
+		{
+			ProjectilePool->PrewarmProjectiles(ProjectileClass, NumPrewarmedProjectiles);
+		}
+	}
+}
+
 void UAuraProjectileSpell::ActivateAbility(const FGameplayAbilitySpecHandle Handle,
                                            const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo,
                                            const FGameplayEventData* TriggerEventData)
@@ -18,47 +39,92 @@ void UAuraProjectileSpell::ActivateAbility(const FGameplayAbilitySpecHandle Hand
 
 void UAuraProjectileSpell::SpawnProjectile(const FVector& ProjectileTargetLocation)
 {
-	
+	SpawnProjectileVolley(ProjectileTargetLocation, 1, 0.f);
+}
+
+void UAuraProjectileSpell::SpawnProjectileVolley(const FVector& ProjectileTargetLocation, int32 NumProjectiles, float SpreadAngle)
+{
 	const bool bIsServer = GetAvatarActorFromActorInfo()->HasAuthority();
-	if (!bIsServer) return;
+	if (!bIsServer || NumProjectiles <= 0) return;
+
+	const FGameplayEffectSpecHandle SpecHandle = MakeVolleyDamageSpec();
 
 	const FVector SocketLocation = ICombatInterface::Execute_GetCombatSocketLocation(GetAvatarActorFromActorInfo());
-	FRotator Rotation = (ProjectileTargetLocation - SocketLocation).Rotation();
-		
-	FTransform SpawnTransform;
-	SpawnTransform.SetLocation(SocketLocation);
-	SpawnTransform.SetRotation(Rotation.Quaternion());
+	const FVector ToTarget = ProjectileTargetLocation - SocketLocation;
+	for (int32 i = 0; i < NumProjectiles; ++i)
+	{
+		// Fanned evenly around the aim direction
+		const float Angle = NumProjectiles > 1 ? SpreadAngle * (static_cast<float>(i) / (NumProjectiles - 1) - 0.5f) : 0.f;
+		const FVector TargetLocation = SocketLocation + ToTarget.RotateAngleAxis(Angle, FVector::UpVector);
+		LaunchVolleyProjectile(SocketLocation, TargetLocation, SpecHandle);
+	}
+}
 
-	AActor* AvatarActor = GetAvatarActorFromActorInfo();
-	AAuraProjectile* Projectile = GetWorld()->SpawnActorDeferred<AAuraProjectile>(
-		ProjectileClass,
-		SpawnTransform,
-		AvatarActor,
-		Cast<APawn>(AvatarActor),
-		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
-
-	const UAbilitySystemComponent* SourceASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent((GetAvatarActorFromActorInfo()));
+FGameplayEffectSpecHandle UAuraProjectileSpell::MakeVolleyDamageSpec()
+{
+	INC_DWORD_STAT(STAT_AuraProjectileDamageSpecsBuilt);
+
+	UAbilitySystemComponent* SourceASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent((GetAvatarActorFromActorInfo()));
 	FGameplayEffectContextHandle EffectContextHandle = SourceASC->MakeEffectContext();
 	EffectContextHandle.SetAbility(this);
-	EffectContextHandle.AddSourceObject(Projectile);
-	TArray<TWeakObjectPtr<AActor>> Actors;
-	Actors.Add(Projectile);
-	EffectContextHandle.AddActors(Actors);
-	FHitResult HitResult;
-	HitResult.Location = ProjectileTargetLocation;
-	EffectContextHandle.AddHitResult(HitResult);
+	// Only the location of the hit result is set, no need to replicate the whole of it
+	UAuraAbilitySystemLibrary::SetUseCompactHitResult(EffectContextHandle, true);
+
+	if (UAuraAbilitySystemComponent* AuraASC = Cast<UAuraAbilitySystemComponent>(SourceASC))
+	{
+		return AuraASC->MakeOutgoingSpecFromTemplate(this, DamageEffectClass, DamageTypes, EffectContextHandle);
+	}
 		
 	const FGameplayEffectSpecHandle SpecHandle = SourceASC->MakeOutgoingSpec(DamageEffectClass, GetAbilityLevel(), EffectContextHandle);
 
-	const FAuraGameplayTags GameplayTags = FAuraGameplayTags::Get();
-
 	for (auto& [DamageType, DamageValue] : DamageTypes)
 	{
-		const float ScaledDamage = DamageValue.GetValueAtLevel(20);
+		const float ScaledDamage = DamageValue.GetValueAtLevel(GetAbilityLevel());
 		UAbilitySystemBlueprintLibrary::AssignTagSetByCallerMagnitude(SpecHandle, DamageType, ScaledDamage);
 	}
-		
-	Projectile->DamageEffectSpecHandle = SpecHandle;
-	Projectile->FinishSpawning(SpawnTransform);
+	return SpecHandle;
 }
 
+AAuraProjectile* UAuraProjectileSpell::LaunchVolleyProjectile(const FVector& SocketLocation, const FVector& ProjectileTargetLocation, const FGameplayEffectSpecHandle& SpecHandle)
+{
+	FRotator Rotation = (ProjectileTargetLocation - SocketLocation).Rotation();
+		
+	FTransform SpawnTransform;
+	SpawnTransform.SetLocation(SocketLocation);
+	SpawnTransform.SetRotation(Rotation.Quaternion());
+
+	AActor* AvatarActor = GetAvatarActorFromActorInfo();
+	UAuraProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UAuraProjectilePoolSubsystem>();
+	AAuraProjectile* Projectile = ProjectilePool
+		? ProjectilePool->AcquireProjectile(ProjectileClass, SpawnTransform, AvatarActor, Cast<APawn>(AvatarActor))
+		: GetWorld()->SpawnActorDeferred<AAuraProjectile>(
+			ProjectileClass,
+			SpawnTransform,
+			AvatarActor,
+			Cast<APawn>(AvatarActor),
+			ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	Projectile->SetSharedDamageSpec(SpecHandle, ProjectileTargetLocation);
+	if (ProjectilePool)
+	{
+		if (Projectile->IsClientSimulated())
+		{
+			Projectile->SetProjectileId(ProjectilePool->GenerateProjectileId());
+		}
+		ProjectilePool->LaunchProjectile(Projectile, SpawnTransform);
+	}
+	else
+	{
+		Projectile->FinishSpawning(SpawnTransform);
+	}
+
+	// Client simulated projectiles don't replicate, clients fly their own from this
+	if (Projectile->GetProjectileId() != 0)
+	{
+		if (AAuraCharacterBase* Caster = Cast<AAuraCharacterBase>(AvatarActor))
+		{
+			Caster->MulticastSpawnProjectile(Projectile->MakeSpawnEvent());
+		}
+	}
+	return Projectile;
+}
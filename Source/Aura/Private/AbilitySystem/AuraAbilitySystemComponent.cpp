@@ -3,12 +3,71 @@
 
 #include "AbilitySystem/AuraAbilitySystemComponent.h"
 
+#include "Aura.h"
 #include "AuraGameplayTags.h"
+#include "TimerManager.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/AuraDerivedAttributeGraph.h"
 #include "AbilitySystem/Abilities/AuraGameplayAbility.h"
+#include "AbilitySystem/ModMagCalc/MMC_DerivedAttribute.h"
+#include "Engine/CurveTable.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Interaction/CombatInterface.h"
+#include "Net/UnrealNetwork.h"
+
+DECLARE_CYCLE_STAT(TEXT("Derived Attributes Flush"), STAT_AuraDerivedAttributesFlush, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spec Template Hits"), STAT_AuraSpecTemplateHits, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spec Template Builds"), STAT_AuraSpecTemplateBuilds, STATGROUP_Aura);
+
+/** Bumped to drop the spec templates of every component. */
+static uint32 GAuraSpecTemplatesGeneration = 0;
+
+static FAutoConsoleCommand CAuraInvalidateSpecTemplates(
+	TEXT("Aura.SpecTemplates.Invalidate"),
+	TEXT("Drops the cached outgoing spec templates of every ability system component."),
+	FConsoleCommandDelegate::CreateStatic(&UAuraAbilitySystemComponent::InvalidateAllSpecTemplates));
 
 void UAuraAbilitySystemComponent::AbilityActorInfoSet()
 {
 	OnGameplayEffectAppliedDelegateToSelf.AddUObject(this, &UAuraAbilitySystemComponent::ClientEffectApplied);
+	InitDerivedAttributeGraph();
+}
+
+void UAuraAbilitySystemComponent::InitializeComponent()
+{
+	Super::InitializeComponent();
+
+	// Only unique on the server, which is the only one assigning them
+	static uint32 GNextDamageRollSourceId = 0;
+	const AActor* Owner = GetOwner();
+	if (Owner && Owner->HasAuthority())
+	{
+		DamageRollSourceId = ++GNextDamageRollSourceId;
+	}
+}
+
+void UAuraAbilitySystemComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UAuraAbilitySystemComponent, DamageRollSourceId);
+}
+
+uint32 UAuraAbilitySystemComponent::ConsumeDamageExecutionIndex(const FPredictionKey& PredictionKey) const
+{
+	if (!PredictionKey.IsValidKey())
+	{
+		// 0 in an effect context means the execution was predicted
+		LastUnpredictedDamageExecutionIndex = FMath::Max(LastUnpredictedDamageExecutionIndex + 1, 1u);
+		return LastUnpredictedDamageExecutionIndex;
+	}
+	if (PredictionKey.Current != DamageExecutionPredictionKey)
+	{
+		DamageExecutionPredictionKey = PredictionKey.Current;
+		NextDamageExecutionIndex = 0;
+	}
+	return NextDamageExecutionIndex++;
 }
 
 void UAuraAbilitySystemComponent::AddCharacterAbilities(const TArray<TSubclassOf<UGameplayAbility>>& StartupAbilities)
@@ -64,3 +123,203 @@ void UAuraAbilitySystemComponent::ClientEffectApplied_Implementation(UAbilitySys
 	
 	
 }
+
+
+/*
+ * Derived Attributes
+ */
+
+void UAuraAbilitySystemComponent::InitDerivedAttributeGraph()
+{
+	const UAuraAttributeSet* AuraAttributeSet = GetSet<UAuraAttributeSet>();
+	if (DerivedAttributeGraph || !AuraAttributeSet || !IsOwnerActorAuthoritative())
+	{
+		return;
+	}
+
+	DerivedAttributeGraph = &FAuraDerivedAttributeGraph::Get(*AuraAttributeSet);
+	OnActiveGameplayEffectAddedDelegateToSelf.AddUObject(this, &UAuraAbilitySystemComponent::OnDerivedAttributeEffectAdded);
+	for (const FGameplayAttribute& Input : DerivedAttributeGraph->GetInputs())
+	{
+		GetGameplayAttributeValueChangeDelegate(Input).AddUObject(this, &UAuraAbilitySystemComponent::OnDerivedAttributeInputChanged);
+	}
+
+	// Effects applied before the graph existed, their inputs may have changed since
+	for (FActiveGameplayEffectsContainer::ConstIterator It = ActiveGameplayEffects.CreateConstIterator(); It; ++It)
+	{
+		OnDerivedAttributeEffectAdded(this, It->Spec, It->Handle);
+	}
+	if (!DerivedAttributeEffects.IsEmpty())
+	{
+		DirtyDerivedAttributes |= DerivedAttributeGraph->GetAllRows();
+		ScheduleDerivedAttributeFlush();
+	}
+}
+
+void UAuraAbilitySystemComponent::OnDerivedAttributeInputChanged(const FOnAttributeChangeData& Data)
+{
+	DirtyDerivedAttributes |= DerivedAttributeGraph->GetDependents(Data.Attribute);
+	ScheduleDerivedAttributeFlush();
+}
+
+void UAuraAbilitySystemComponent::MarkDerivedAttributeLevelDirty()
+{
+	if (!DerivedAttributeGraph)
+	{
+		return;
+	}
+	DirtyDerivedAttributes |= DerivedAttributeGraph->GetLevelDependents();
+	ScheduleDerivedAttributeFlush();
+}
+
+void UAuraAbilitySystemComponent::FlushDerivedAttributes()
+{
+	SCOPE_CYCLE_COUNTER(STAT_AuraDerivedAttributesFlush);
+
+	bDerivedAttributeFlushPending = false;
+	const uint32 DirtyRows = DirtyDerivedAttributes;
+	DirtyDerivedAttributes = 0;
+	if (!DerivedAttributeGraph || DirtyRows == 0)
+	{
+		return;
+	}
+
+	// One pass over the current inputs, for every row: the re-evaluated effects may use clean rows too
+	FAuraDerivedAttributeInputs Inputs;
+	Inputs.Strength = FMath::Max<float>(GetNumericAttribute(UAuraAttributeSet::GetStrengthAttribute()), 0.f);
+	Inputs.Intelligence = FMath::Max<float>(GetNumericAttribute(UAuraAttributeSet::GetIntelligenceAttribute()), 0.f);
+	Inputs.Resilience = FMath::Max<float>(GetNumericAttribute(UAuraAttributeSet::GetResilienceAttribute()), 0.f);
+	Inputs.Vigor = FMath::Max<float>(GetNumericAttribute(UAuraAttributeSet::GetVigorAttribute()), 0.f);
+	if (ICombatInterface* CombatInterface = Cast<ICombatInterface>(GetAvatarActor()))
+	{
+		Inputs.Level = CombatInterface->GetPlayerLevel();
+	}
+
+	float Values[static_cast<int32>(EAuraDerivedAttribute::Num)];
+	UMMC_DerivedAttribute::EvaluateAll(Inputs, Values);
+
+	TMap<FGameplayTag, float> Magnitudes;
+	for (int32 Index = 0; Index < static_cast<int32>(EAuraDerivedAttribute::Num); ++Index)
+	{
+		Magnitudes.Add(UMMC_DerivedAttribute::GetSetByCallerTag(static_cast<EAuraDerivedAttribute>(Index)), Values[Index]);
+	}
+
+	// Unlike SetActiveGameplayEffectLevel, the SetByCaller update re-runs the modifiers even at an unchanged level
+	for (TMap<FActiveGameplayEffectHandle, uint32>::TIterator It = DerivedAttributeEffects.CreateIterator(); It; ++It)
+	{
+		if (!GetActiveGameplayEffect(It.Key()))
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		if (It.Value() & DirtyRows)
+		{
+			UpdateActiveGameplayEffectSetByCallerMagnitudes(It.Key(), Magnitudes);
+		}
+	}
+}
+
+void UAuraAbilitySystemComponent::OnDerivedAttributeEffectAdded(UAbilitySystemComponent* AbilitySystemComponent,
+	const FGameplayEffectSpec& EffectSpec, FActiveGameplayEffectHandle ActiveEffectHandle)
+{
+	uint32 Rows = 0;
+	for (const FGameplayModifierInfo& Modifier : EffectSpec.Def->Modifiers)
+	{
+		if (const UClass* CalculationClass = Modifier.ModifierMagnitude.GetCustomMagnitudeCalculationClass())
+		{
+			if (const UMMC_DerivedAttribute* Calculation = Cast<UMMC_DerivedAttribute>(CalculationClass->GetDefaultObject()))
+			{
+				Rows |= 1u << static_cast<uint32>(Calculation->GetDerivedAttribute());
+			}
+		}
+	}
+
+	if (Rows != 0)
+	{
+		DerivedAttributeEffects.Add(ActiveEffectHandle, Rows);
+	}
+}
+
+void UAuraAbilitySystemComponent::ScheduleDerivedAttributeFlush()
+{
+	if (bDerivedAttributeFlushPending)
+	{
+		return;
+	}
+	if (const UWorld* World = GetWorld())
+	{
+		bDerivedAttributeFlushPending = true;
+		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &UAuraAbilitySystemComponent::FlushDerivedAttributes));
+	}
+}
+
+
+/*
+ * Outgoing Spec Templates
+ */
+
+FGameplayEffectSpecHandle UAuraAbilitySystemComponent::MakeOutgoingSpecFromTemplate(const UGameplayAbility* Ability, TSubclassOf<UGameplayEffect> EffectClass,
+	const TMap<FGameplayTag, FScalableFloat>& SetByCallerMagnitudes, const FGameplayEffectContextHandle& EffectContext)
+{
+	check(Ability);
+
+	if (SpecTemplatesGeneration != GAuraSpecTemplatesGeneration)
+	{
+		SpecTemplates.Reset();
+		SpecTemplatesGeneration = GAuraSpecTemplatesGeneration;
+	}
+
+	const int32 Level = Ability->GetAbilityLevel();
+	TSharedPtr<const FGameplayEffectSpec>& Template = SpecTemplates.FindOrAdd(FSpecTemplateKey(Ability->GetClass(), Level));
+	if (Template.IsValid())
+	{
+		INC_DWORD_STAT(STAT_AuraSpecTemplateHits);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_AuraSpecTemplateBuilds);
+
+		const FGameplayEffectSpecHandle TemplateHandle = MakeOutgoingSpec(EffectClass, Level, EffectContext);
+		if (!TemplateHandle.IsValid())
+		{
+			SpecTemplates.Remove(FSpecTemplateKey(Ability->GetClass(), Level));
+			return TemplateHandle;
+		}
+		for (const TPair<FGameplayTag, FScalableFloat>& Pair : SetByCallerMagnitudes)
+		{
+			TemplateHandle.Data->SetSetByCallerMagnitude(Pair.Key, Pair.Value.GetValueAtLevel(Level));
+#if WITH_EDITOR
+			BindSpecTemplateCurveTable(Pair.Value.Curve.CurveTable);
+#endif
+		}
+		Template = TemplateHandle.Data;
+	}
+	ensureMsgf(Template->Def->GetClass() == EffectClass, TEXT("%s makes several effect classes, it has one spec template per level"), *GetNameSafe(Ability->GetClass()));
+
+	FGameplayEffectSpec* Spec = new FGameplayEffectSpec(*Template);
+	// Also captures the current source tags, the template's are from when it was built
+	Spec->SetContext(EffectContext);
+	return FGameplayEffectSpecHandle(Spec);
+}
+
+void UAuraAbilitySystemComponent::InvalidateSpecTemplates()
+{
+	SpecTemplates.Reset();
+}
+
+void UAuraAbilitySystemComponent::InvalidateAllSpecTemplates()
+{
+	++GAuraSpecTemplatesGeneration;
+}
+
+#if WITH_EDITOR
+void UAuraAbilitySystemComponent::BindSpecTemplateCurveTable(UCurveTable* CurveTable)
+{
+	// Rebuild the templates when a curve table they read is reimported or edited
+	if (CurveTable && !SpecTemplateCurveTables.Contains(CurveTable))
+	{
+		CurveTable->OnCurveTableChanged().AddUObject(this, &UAuraAbilitySystemComponent::InvalidateSpecTemplates);
+		SpecTemplateCurveTables.Add(CurveTable);
+	}
+}
+#endif
@@ -7,11 +7,36 @@
 #include "AuraGameplayTags.h"
 #include "GameplayEffectExtension.h"
 #include "AbilitySystem/AuraAbilitySystemLibrary.h"
+#include "Engine/NetDriver.h"
 #include "GameFramework/Character.h"
+#include "HAL/IConsoleManager.h"
 #include "Interaction/CombatInterface.h"
 #include "Kismet/GameplayStatics.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Net/UnrealNetwork.h"
 #include "Player/AuraPlayerController.h"
+#include "UObject/UObjectIterator.h"
+
+static bool GAuraReplicateAllAttributesToSimulatedProxies = false;
+
+static void OnReplicateAllAttributesToSimulatedProxiesChanged(IConsoleVariable* Variable)
+{
+	for (TObjectIterator<UAuraAttributeSet> It; It; ++It)
+	{
+		if (!It->IsTemplate())
+		{
+			It->RefreshReplicatedAttributes();
+		}
+	}
+}
+
+static FAutoConsoleVariableRef CVarAuraReplicateAllAttributesToSimulatedProxies(
+	TEXT("Aura.Net.ReplicateAllAttributesToSimulatedProxies"),
+	GAuraReplicateAllAttributesToSimulatedProxies,
+	TEXT("Server only. Also sends primary, secondary and resistance attributes to simulated proxies, not just the vitals. ")
+	TEXT("Changing it resends every attribute set in full."),
+	FConsoleVariableDelegate::CreateStatic(&OnReplicateAllAttributesToSimulatedProxiesChanged),
+	ECVF_Default);
 
 UAuraAttributeSet::UAuraAttributeSet()
 {
@@ -47,43 +72,154 @@ void UAuraAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Ou
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
+	// Push model: attributes are only compared for replication after MarkAttributeDirty flagged them.
+	// Only the owning client gets the full-precision attributes. Enemies are owned by the server, so they go to nobody.
+	FDoRepLifetimeParams OwnerOnlyParams;
+	OwnerOnlyParams.bIsPushBased = true;
+	OwnerOnlyParams.RepNotifyCondition = REPNOTIFY_Always;
+	OwnerOnlyParams.Condition = COND_OwnerOnly;
+
+	// Everyone else gets the quantized copies (health bars)
+	FDoRepLifetimeParams SimulatedProxyParams;
+	SimulatedProxyParams.bIsPushBased = true;
+	SimulatedProxyParams.Condition = COND_SkipOwner;
+
 	/* Primary Attributes */
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Strength, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Intelligence, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Resilience, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Vigor, COND_None, REPNOTIFY_Always);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Strength, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Intelligence, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Resilience, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Vigor, OwnerOnlyParams);
 	/* end Primary Attributes */
 	
 	/* Vital Attributes */
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Health, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, MaxHealth, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Mana, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, MaxMana, COND_None, REPNOTIFY_Always);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Health, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, MaxHealth, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Mana, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, MaxMana, OwnerOnlyParams);
 	/* end Vital Attributes */
 
-	/* Secondary Attributes */
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Armor, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, ArmorPenetration, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, BlockChance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, CriticalHitChance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, CriticalHitDamage, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, CriticalHitResistance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, HealthRegeneration, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, ManaRegeneration, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, MaxHealth, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, MaxMana, COND_None, REPNOTIFY_Always);
+	/* Secondary Attributes (MaxHealth and MaxMana are registered with the Vital Attributes) */
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Armor, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, ArmorPenetration, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, BlockChance, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, CriticalHitChance, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, CriticalHitDamage, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, CriticalHitResistance, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, HealthRegeneration, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, ManaRegeneration, OwnerOnlyParams);
 	/* end Secondary Attributes */
 
 	/* Resistance Attributes */
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, FireResistance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, LightningResistance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, ArcaneResistance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, PhysicalResistance, COND_None, REPNOTIFY_Always);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, FireResistance, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, LightningResistance, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, ArcaneResistance, OwnerOnlyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, PhysicalResistance, OwnerOnlyParams);
 	/* end Resistance Attributes */
+
+	/* Simulated Proxies */
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, ReplicatedVitals, SimulatedProxyParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, ReplicatedAttributes, SimulatedProxyParams);
+	/* end Simulated Proxies */
 	
 	
 }
 
+void UAuraAttributeSet::PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue)
+{
+	Super::PostAttributeChange(Attribute, OldValue, NewValue);
+
+	if (OldValue != NewValue)
+	{
+		MarkAttributeDirty(Attribute);
+		UpdateReplicatedAttributes(Attribute);
+	}
+}
+
+void UAuraAttributeSet::PostAttributeBaseChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) const
+{
+	Super::PostAttributeBaseChange(Attribute, OldValue, NewValue);
+
+	// The base value replicates too, so a base-only change still needs to be sent
+	if (OldValue != NewValue)
+	{
+		MarkAttributeDirty(Attribute);
+	}
+}
+
+void UAuraAttributeSet::MarkAttributeDirty(const FGameplayAttribute& Attribute) const
+{
+	const FProperty* Property = Attribute.GetUProperty();
+	if (Property && Property->HasAnyPropertyFlags(CPF_Net))
+	{
+		MARK_PROPERTY_DIRTY(this, Property);
+	}
+}
+
+void UAuraAttributeSet::UpdateReplicatedAttributes(const FGameplayAttribute& Attribute)
+{
+	const AActor* OwningActor = GetOwningActor();
+	if (!OwningActor || !OwningActor->HasAuthority())
+	{
+		return;
+	}
+
+	// The fractions also move when the max does
+	bool bVitalsChanged = false;
+	if (Attribute == GetHealthAttribute() || Attribute == GetMaxHealthAttribute())
+	{
+		bVitalsChanged |= ReplicatedVitals.Set(EAuraReplicatedAttribute::Health, GetHealth(), GetMaxHealth());
+	}
+	if (Attribute == GetManaAttribute() || Attribute == GetMaxManaAttribute())
+	{
+		bVitalsChanged |= ReplicatedVitals.Set(EAuraReplicatedAttribute::Mana, GetMana(), GetMaxMana());
+	}
+	if (bVitalsChanged)
+	{
+		MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, ReplicatedVitals, this);
+	}
+
+	for (int32 Index = static_cast<int32>(EAuraReplicatedAttribute::MaxHealth); Index < FAuraReplicatedAttributes::NumFields; ++Index)
+	{
+		const EAuraReplicatedAttribute Field = static_cast<EAuraReplicatedAttribute>(Index);
+		if (GetReplicatedAttribute(Field) != Attribute)
+		{
+			continue;
+		}
+
+		const bool bIsMaxVital = Field <= EAuraReplicatedAttribute::MaxMana;
+		if ((bIsMaxVital || GAuraReplicateAllAttributesToSimulatedProxies) && ReplicatedAttributes.Set(Field, Attribute.GetNumericValue(this)))
+		{
+			MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, ReplicatedAttributes, this);
+		}
+		break;
+	}
+}
+
+void UAuraAttributeSet::RefreshReplicatedAttributes()
+{
+	const AActor* OwningActor = GetOwningActor();
+	if (!OwningActor || !OwningActor->HasAuthority())
+	{
+		return;
+	}
+
+	ReplicatedVitals.Set(EAuraReplicatedAttribute::Health, GetHealth(), GetMaxHealth());
+	ReplicatedVitals.Set(EAuraReplicatedAttribute::Mana, GetMana(), GetMaxMana());
+
+	// Attributes no longer sent go back to zero, as if they never had been
+	for (int32 Index = static_cast<int32>(EAuraReplicatedAttribute::MaxHealth); Index < FAuraReplicatedAttributes::NumFields; ++Index)
+	{
+		const EAuraReplicatedAttribute Field = static_cast<EAuraReplicatedAttribute>(Index);
+		const bool bIsMaxVital = Field <= EAuraReplicatedAttribute::MaxMana;
+		ReplicatedAttributes.Set(Field, bIsMaxVital || GAuraReplicateAllAttributesToSimulatedProxies ? GetReplicatedAttribute(Field).GetNumericValue(this) : 0.f);
+	}
+
+	ReplicatedVitals.ForceFullResend();
+	ReplicatedAttributes.ForceFullResend();
+	MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, ReplicatedVitals, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, ReplicatedAttributes, this);
+}
+
 void UAuraAttributeSet::PreAttributeBaseChange(const FGameplayAttribute& Attribute, float& NewValue) const
 {
 	Super::PreAttributeBaseChange(Attribute, NewValue);
@@ -324,3 +460,110 @@ void UAuraAttributeSet::OnRep_PhysicalResistance(const FGameplayAttributeData& O
 {
 	GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, PhysicalResistance, OldPhysicalResistance);
 }
+
+
+/*
+ * Simulated Proxies
+ */
+
+FGameplayAttribute UAuraAttributeSet::GetReplicatedAttribute(EAuraReplicatedAttribute Field)
+{
+	switch (Field)
+	{
+	case EAuraReplicatedAttribute::Health: return GetHealthAttribute();
+	case EAuraReplicatedAttribute::Mana: return GetManaAttribute();
+	case EAuraReplicatedAttribute::MaxHealth: return GetMaxHealthAttribute();
+	case EAuraReplicatedAttribute::MaxMana: return GetMaxManaAttribute();
+	case EAuraReplicatedAttribute::Strength: return GetStrengthAttribute();
+	case EAuraReplicatedAttribute::Intelligence: return GetIntelligenceAttribute();
+	case EAuraReplicatedAttribute::Resilience: return GetResilienceAttribute();
+	case EAuraReplicatedAttribute::Vigor: return GetVigorAttribute();
+	case EAuraReplicatedAttribute::Armor: return GetArmorAttribute();
+	case EAuraReplicatedAttribute::ArmorPenetration: return GetArmorPenetrationAttribute();
+	case EAuraReplicatedAttribute::CriticalHitDamage: return GetCriticalHitDamageAttribute();
+	case EAuraReplicatedAttribute::HealthRegeneration: return GetHealthRegenerationAttribute();
+	case EAuraReplicatedAttribute::ManaRegeneration: return GetManaRegenerationAttribute();
+	case EAuraReplicatedAttribute::BlockChance: return GetBlockChanceAttribute();
+	case EAuraReplicatedAttribute::CriticalHitChance: return GetCriticalHitChanceAttribute();
+	case EAuraReplicatedAttribute::CriticalHitResistance: return GetCriticalHitResistanceAttribute();
+	case EAuraReplicatedAttribute::FireResistance: return GetFireResistanceAttribute();
+	case EAuraReplicatedAttribute::LightningResistance: return GetLightningResistanceAttribute();
+	case EAuraReplicatedAttribute::ArcaneResistance: return GetArcaneResistanceAttribute();
+	case EAuraReplicatedAttribute::PhysicalResistance: return GetPhysicalResistanceAttribute();
+	default: return FGameplayAttribute();
+	}
+}
+
+void UAuraAttributeSet::OnRep_ReplicatedVitals()
+{
+	ApplyReplicatedAttributes();
+}
+
+void UAuraAttributeSet::OnRep_ReplicatedAttributes()
+{
+	ApplyReplicatedAttributes();
+}
+
+void UAuraAttributeSet::ApplyReplicatedAttributes()
+{
+	// Max values first, the vitals are scaled by them
+	for (int32 Index = static_cast<int32>(EAuraReplicatedAttribute::MaxHealth); Index < FAuraReplicatedAttributes::NumFields; ++Index)
+	{
+		const EAuraReplicatedAttribute Field = static_cast<EAuraReplicatedAttribute>(Index);
+		ApplyReplicatedValue(GetReplicatedAttribute(Field), ReplicatedAttributes.Get(Field));
+	}
+
+	ApplyReplicatedValue(GetHealthAttribute(), ReplicatedVitals.Get(EAuraReplicatedAttribute::Health) * GetMaxHealth());
+	ApplyReplicatedValue(GetManaAttribute(), ReplicatedVitals.Get(EAuraReplicatedAttribute::Mana) * GetMaxMana());
+}
+
+void UAuraAttributeSet::ApplyReplicatedValue(const FGameplayAttribute& Attribute, float NewValue)
+{
+	FGameplayAttributeData* Data = Attribute.GetGameplayAttributeData(this);
+	if (!Data || Data->GetCurrentValue() == NewValue)
+	{
+		return;
+	}
+
+	const FGameplayAttributeData OldData = *Data;
+	Data->SetBaseValue(NewValue);
+	Data->SetCurrentValue(NewValue);
+	GetOwningAbilitySystemComponentChecked()->SetBaseAttributeValueFromReplication(Attribute, *Data, OldData);
+}
+
+/* Bandwidth report */
+
+static uint64 GAuraAttributeBandwidthDriverBytesAtReset = 0;
+
+static void ReportAttributeBandwidth(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	const uint64 DriverBytes = NetDriver ? static_cast<uint64>(NetDriver->OutTotalBytes) : 0;
+
+	if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+	{
+		FAuraReplicatedAttributes::ResetNetStats();
+		GAuraAttributeBandwidthDriverBytesAtReset = DriverBytes;
+		Ar.Logf(TEXT("Attribute bandwidth counters reset."));
+		return;
+	}
+
+	// Measured where the copies are serialized, per connection, so the property handles and packet headers are not included
+	const FAuraReplicatedAttributesNetStats& Stats = FAuraReplicatedAttributes::GetNetStats();
+	const uint64 Bytes = (Stats.NumBits + 7) / 8;
+	const uint64 DriverBytesSinceReset = DriverBytes - FMath::Min(DriverBytes, GAuraAttributeBandwidthDriverBytesAtReset);
+
+	Ar.Logf(TEXT("Simulated proxy attribute copies: %llu updates (%llu full resends), %llu fields, %llu bits."),
+		Stats.NumUpdates, Stats.NumFullUpdates, Stats.NumFields, Stats.NumBits);
+	Ar.Logf(TEXT("Per update: %.1f fields, %.1f bits."),
+		Stats.NumUpdates > 0 ? static_cast<double>(Stats.NumFields) / Stats.NumUpdates : 0.0,
+		Stats.NumUpdates > 0 ? static_cast<double>(Stats.NumBits) / Stats.NumUpdates : 0.0);
+	Ar.Logf(TEXT("Net driver sent %llu bytes over the same period, %.2f%% of it attribute copies."),
+		DriverBytesSinceReset, DriverBytesSinceReset > 0 ? 100.0 * Bytes / DriverBytesSinceReset : 0.0);
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice CmdAuraAttributeBandwidthReport(
+	TEXT("Aura.Net.AttributeBandwidthReport"),
+	TEXT("Bits actually sent for the simulated proxy attribute copies since the last 'Aura.Net.AttributeBandwidthReport reset', ")
+	TEXT("against the net driver's total. Run on the server."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&ReportAttributeBandwidth));
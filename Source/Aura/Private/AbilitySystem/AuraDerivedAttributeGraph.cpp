@@ -0,0 +1,70 @@
+// Giorjorio Copyright
+
+
+#include "AbilitySystem/AuraDerivedAttributeGraph.h"
+
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/ModMagCalc/MMC_DerivedAttribute.h"
+#include "UObject/UObjectHash.h"
+
+static_assert(static_cast<int32>(EAuraDerivedAttribute::Num) <= 32, "Rows are stored in uint32 masks");
+
+const FAuraDerivedAttributeGraph& FAuraDerivedAttributeGraph::Get(const UAuraAttributeSet& AttributeSet)
+{
+	static const FAuraDerivedAttributeGraph Graph(AttributeSet);
+	return Graph;
+}
+
+FAuraDerivedAttributeGraph::FAuraDerivedAttributeGraph(const UAuraAttributeSet& AttributeSet)
+{
+	TArray<UClass*> CalculationClasses;
+	GetDerivedClasses(UMMC_DerivedAttribute::StaticClass(), CalculationClasses);
+
+	TArray<const UMMC_DerivedAttribute*> Calculations;
+	for (const UClass* CalculationClass : CalculationClasses)
+	{
+		if (!CalculationClass->HasAnyClassFlags(CLASS_Abstract))
+		{
+			Calculations.Add(CalculationClass->GetDefaultObject<UMMC_DerivedAttribute>());
+		}
+	}
+
+	for (const UMMC_DerivedAttribute* Calculation : Calculations)
+	{
+		const uint32 Row = 1u << static_cast<uint32>(Calculation->GetDerivedAttribute());
+		AllRows |= Row;
+		if (UMMC_DerivedAttribute::GetFormula(Calculation->GetDerivedAttribute()).LevelCoefficient != 0.f)
+		{
+			LevelDependents |= Row;
+		}
+	}
+
+	for (const TPair<FGameplayTag, TStaticFuncPtr<FGameplayAttribute()>>& Pair : AttributeSet.TagsToAttributes)
+	{
+		const FGameplayAttribute Attribute = Pair.Value();
+
+		uint32 Rows = 0;
+		for (const UMMC_DerivedAttribute* Calculation : Calculations)
+		{
+			for (const FGameplayEffectAttributeCaptureDefinition& Definition : Calculation->GetAttributeCaptureDefinitions())
+			{
+				if (Definition.AttributeToCapture == Attribute)
+				{
+					Rows |= 1u << static_cast<uint32>(Calculation->GetDerivedAttribute());
+				}
+			}
+		}
+
+		if (Rows != 0)
+		{
+			Inputs.Add(Attribute);
+			Dependents.Add(Rows);
+		}
+	}
+}
+
+uint32 FAuraDerivedAttributeGraph::GetDependents(const FGameplayAttribute& Attribute) const
+{
+	const int32 Index = Inputs.IndexOfByKey(Attribute);
+	return Index != INDEX_NONE ? Dependents[Index] : 0;
+}
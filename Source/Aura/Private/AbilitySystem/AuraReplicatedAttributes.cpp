@@ -0,0 +1,208 @@
+// Giorjorio Copyright
+
+
+#include "AbilitySystem/AuraReplicatedAttributes.h"
+
+#include "Aura/Aura.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Replicated Attributes Bits Sent"), STAT_AuraReplicatedAttributesBits, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Replicated Attributes Fields Sent"), STAT_AuraReplicatedAttributesFields, STATGROUP_Aura);
+
+static_assert(FAuraReplicatedAttributes::NumFields <= 32, "The dirty mask is a single uint32");
+
+enum class EAuraAttributeQuantization : uint8
+{
+	Integer,
+	Tenths,
+	Percent,
+	Fraction
+};
+
+/* 0.1% steps over [0, 100] */
+static constexpr uint32 PercentSteps = 1000;
+
+/* Health and Mana fractions */
+static constexpr uint32 FractionBits = 16;
+static constexpr uint32 FractionMax = (1u << FractionBits) - 1;
+
+static EAuraAttributeQuantization GetQuantization(EAuraReplicatedAttribute Field)
+{
+	if (Field <= EAuraReplicatedAttribute::Mana)
+	{
+		return EAuraAttributeQuantization::Fraction;
+	}
+	if (Field <= EAuraReplicatedAttribute::Vigor)
+	{
+		return EAuraAttributeQuantization::Integer;
+	}
+	if (Field <= EAuraReplicatedAttribute::ManaRegeneration)
+	{
+		return EAuraAttributeQuantization::Tenths;
+	}
+	return EAuraAttributeQuantization::Percent;
+}
+
+bool FAuraReplicatedAttributes::Set(EAuraReplicatedAttribute Field, float Value, float MaxValue)
+{
+	uint32 NewQuantized = 0;
+	switch (GetQuantization(Field))
+	{
+	case EAuraAttributeQuantization::Integer:
+		NewQuantized = static_cast<uint32>(FMath::RoundToInt(FMath::Max(Value, 0.f)));
+		break;
+	case EAuraAttributeQuantization::Tenths:
+		NewQuantized = static_cast<uint32>(FMath::RoundToInt(FMath::Max(Value, 0.f) * 10.f));
+		break;
+	case EAuraAttributeQuantization::Percent:
+		NewQuantized = static_cast<uint32>(FMath::RoundToInt(FMath::Clamp(Value, 0.f, 100.f) * (PercentSteps / 100.f)));
+		break;
+	case EAuraAttributeQuantization::Fraction:
+		NewQuantized = MaxValue > 0.f ? static_cast<uint32>(FMath::RoundToInt(FMath::Clamp(Value / MaxValue, 0.f, 1.f) * FractionMax)) : 0;
+		break;
+	}
+
+	uint32& Stored = Quantized[static_cast<int32>(Field)];
+	const bool bChanged = Stored != NewQuantized;
+	Stored = NewQuantized;
+	return bChanged;
+}
+
+float FAuraReplicatedAttributes::Get(EAuraReplicatedAttribute Field) const
+{
+	const uint32 Stored = Quantized[static_cast<int32>(Field)];
+	switch (GetQuantization(Field))
+	{
+	case EAuraAttributeQuantization::Tenths:
+		return Stored / 10.f;
+	case EAuraAttributeQuantization::Percent:
+		return Stored * (100.f / PercentSteps);
+	case EAuraAttributeQuantization::Fraction:
+		return Stored / static_cast<float>(FractionMax);
+	default:
+		return static_cast<float>(Stored);
+	}
+}
+
+/* The values a connection was last sent */
+class FAuraReplicatedAttributesDeltaState : public INetDeltaBaseState
+{
+public:
+
+	virtual bool IsStateEqual(INetDeltaBaseState* OtherState) override
+	{
+		const FAuraReplicatedAttributesDeltaState* Other = static_cast<FAuraReplicatedAttributesDeltaState*>(OtherState);
+		return FullResendGeneration == Other->FullResendGeneration && FMemory::Memcmp(Quantized, Other->Quantized, sizeof(Quantized)) == 0;
+	}
+
+	uint32 Quantized[FAuraReplicatedAttributes::NumFields] = {};
+	uint8 FullResendGeneration = 0;
+};
+
+static FAuraReplicatedAttributesNetStats GAuraReplicatedAttributesNetStats;
+
+template<typename ArchiveType>
+static void SerializeField(ArchiveType& Ar, EAuraReplicatedAttribute Field, uint32& Value)
+{
+	switch (GetQuantization(Field))
+	{
+	case EAuraAttributeQuantization::Percent:
+		Ar.SerializeInt(Value, PercentSteps + 1);
+		break;
+	case EAuraAttributeQuantization::Fraction:
+		Ar.SerializeBits(&Value, FractionBits);
+		break;
+	default:
+		Ar.SerializeIntPacked(Value);
+		break;
+	}
+}
+
+bool FAuraReplicatedAttributes::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	// No object references to map
+	if (DeltaParms.GatherGuidReferences || DeltaParms.bUpdateUnmappedObjects)
+	{
+		return true;
+	}
+	if (DeltaParms.MoveGuidToUnmapped)
+	{
+		return false;
+	}
+
+	if (DeltaParms.Writer)
+	{
+		const FAuraReplicatedAttributesDeltaState* OldState = static_cast<const FAuraReplicatedAttributesDeltaState*>(DeltaParms.OldState);
+		const bool bFullResend = OldState && OldState->FullResendGeneration != FullResendGeneration;
+
+		// Against zeros for a new connection, whose copy starts zeroed
+		uint32 DirtyMask = 0;
+		for (int32 Index = 0; Index < NumFields; ++Index)
+		{
+			const uint32 SentValue = OldState ? OldState->Quantized[Index] : 0;
+			if (bFullResend || Quantized[Index] != SentValue)
+			{
+				DirtyMask |= 1u << Index;
+			}
+		}
+		if (OldState && DirtyMask == 0)
+		{
+			return false;
+		}
+
+		TSharedPtr<FAuraReplicatedAttributesDeltaState> NewState = MakeShared<FAuraReplicatedAttributesDeltaState>();
+		FMemory::Memcpy(NewState->Quantized, Quantized, sizeof(Quantized));
+		NewState->FullResendGeneration = FullResendGeneration;
+		*DeltaParms.NewState = NewState;
+
+		FBitWriter& Writer = *DeltaParms.Writer;
+		const int64 StartBits = Writer.GetNumBits();
+		Writer.SerializeIntPacked(DirtyMask);
+		for (int32 Index = 0; Index < NumFields; ++Index)
+		{
+			if (DirtyMask & (1u << Index))
+			{
+				SerializeField(Writer, static_cast<EAuraReplicatedAttribute>(Index), Quantized[Index]);
+			}
+		}
+
+		const int64 NumBits = Writer.GetNumBits() - StartBits;
+		const int32 NumFieldsSent = FMath::CountBits(DirtyMask);
+		++GAuraReplicatedAttributesNetStats.NumUpdates;
+		GAuraReplicatedAttributesNetStats.NumFullUpdates += bFullResend ? 1 : 0;
+		GAuraReplicatedAttributesNetStats.NumFields += NumFieldsSent;
+		GAuraReplicatedAttributesNetStats.NumBits += NumBits;
+		INC_DWORD_STAT_BY(STAT_AuraReplicatedAttributesBits, NumBits);
+		INC_DWORD_STAT_BY(STAT_AuraReplicatedAttributesFields, NumFieldsSent);
+		return true;
+	}
+
+	if (DeltaParms.Reader)
+	{
+		// Fields outside the mask keep the value from the previous update
+		FBitReader& Reader = *DeltaParms.Reader;
+		uint32 DirtyMask = 0;
+		Reader.SerializeIntPacked(DirtyMask);
+		for (int32 Index = 0; Index < NumFields && !Reader.IsError(); ++Index)
+		{
+			if (DirtyMask & (1u << Index))
+			{
+				SerializeField(Reader, static_cast<EAuraReplicatedAttribute>(Index), Quantized[Index]);
+			}
+		}
+		return !Reader.IsError();
+	}
+
+	return true;
+}
+
+const FAuraReplicatedAttributesNetStats& FAuraReplicatedAttributes::GetNetStats()
+{
+	return GAuraReplicatedAttributesNetStats;
+}
+
+void FAuraReplicatedAttributes::ResetNetStats()
+{
+	GAuraReplicatedAttributesNetStats = FAuraReplicatedAttributesNetStats();
+}
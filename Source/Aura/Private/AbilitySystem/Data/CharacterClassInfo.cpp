@@ -3,7 +3,160 @@
 
 #include "AbilitySystem/Data/CharacterClassInfo.h"
 
+#include "Engine/CurveTable.h"
+
+#if WITH_EDITOR
+#include "Misc/DataValidation.h"
+#endif
+
 FCharacterClassDefaultInfo UCharacterClassInfo::GetClassDefaultInfo(ECharacterClass CharacterClass) const
 {
 	return CharacterClassInformation.FindChecked(CharacterClass);
 }
+
+void UCharacterClassInfo::PostLoad()
+{
+	Super::PostLoad();
+
+	// Bad data fails at load rather than on the first hit. The lookups then read zeros.
+	TArray<FString> Errors;
+	ensureMsgf(BakeDamageCalculationCoefficients(Errors), TEXT("CharacterClassInfo [%s] baked zeros for its missing Damage Calculation Coefficients: %s"),
+		*GetNameSafe(this), *FString::Join(Errors, TEXT(" ")));
+}
+
+float UCharacterClassInfo::GetArmorPenetrationCoefficient(int32 Level) const
+{
+	return GetCoefficient(ArmorPenetrationCoefficients, Level);
+}
+
+float UCharacterClassInfo::GetEffectiveArmorCoefficient(int32 Level) const
+{
+	return GetCoefficient(EffectiveArmorCoefficients, Level);
+}
+
+float UCharacterClassInfo::GetCriticalHitResistanceCoefficient(int32 Level) const
+{
+	return GetCoefficient(CriticalHitResistanceCoefficients, Level);
+}
+
+float UCharacterClassInfo::GetCoefficient(const TArray<float>& Coefficients, int32 Level)
+{
+	// Empty only on an instance that was never loaded
+	return Coefficients.IsEmpty() ? 0.f : Coefficients[FMath::Clamp(Level, 1, Coefficients.Num()) - 1];
+}
+
+#if WITH_EDITOR
+void UCharacterClassInfo::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UCharacterClassInfo, DamageCalculationCoefficients) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(UCharacterClassInfo, MaxCoefficientLevel))
+	{
+		RebakeDamageCalculationCoefficients();
+	}
+}
+
+EDataValidationResult UCharacterClassInfo::IsDataValid(FDataValidationContext& Context) const
+{
+	EDataValidationResult Result = Super::IsDataValid(Context);
+
+	TArray<FString> Errors;
+	FindDamageCalculationCoefficientCurves(Errors);
+	for (const FString& Error : Errors)
+	{
+		Context.AddError(FText::FromString(Error));
+		Result = EDataValidationResult::Invalid;
+	}
+	return Result;
+}
+
+void UCharacterClassInfo::RebakeDamageCalculationCoefficients()
+{
+	TArray<FString> Errors;
+	BakeDamageCalculationCoefficients(Errors);
+	for (const FString& Error : Errors)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+	}
+}
+#endif
+
+TArray<const FRealCurve*> UCharacterClassInfo::FindDamageCalculationCoefficientCurves(TArray<FString>& OutErrors) const
+{
+	static const FName CurveNames[] = { FName("ArmorPenetration"), FName("EffectiveArmor"), FName("CriticalHitResistance") };
+
+	TArray<const FRealCurve*> Curves;
+	Curves.Init(nullptr, UE_ARRAY_COUNT(CurveNames));
+	if (DamageCalculationCoefficients == nullptr)
+	{
+		OutErrors.Add(FString::Printf(TEXT("DamageCalculationCoefficients is not set on CharacterClassInfo [%s]."), *GetNameSafe(this)));
+		return Curves;
+	}
+	for (int32 CurveIndex = 0; CurveIndex < UE_ARRAY_COUNT(CurveNames); ++CurveIndex)
+	{
+		Curves[CurveIndex] = DamageCalculationCoefficients->FindCurve(CurveNames[CurveIndex], FString(), false);
+		if (Curves[CurveIndex] == nullptr)
+		{
+			OutErrors.Add(FString::Printf(TEXT("Can't find curve [%s] in DamageCalculationCoefficients [%s] on CharacterClassInfo [%s]."),
+				*CurveNames[CurveIndex].ToString(), *GetNameSafe(DamageCalculationCoefficients), *GetNameSafe(this)));
+		}
+	}
+	return Curves;
+}
+
+bool UCharacterClassInfo::BakeDamageCalculationCoefficients(TArray<FString>& OutErrors)
+{
+	if (DamageCalculationCoefficients)
+	{
+		DamageCalculationCoefficients->ConditionalPostLoad();
+	}
+
+#if WITH_EDITOR
+	// Re-bake when the curve table is reimported or edited
+	if (BoundCoefficientsTable.Get() != DamageCalculationCoefficients)
+	{
+		if (UCurveTable* OldTable = BoundCoefficientsTable.Get())
+		{
+			OldTable->OnCurveTableChanged().RemoveAll(this);
+		}
+		if (DamageCalculationCoefficients)
+		{
+			DamageCalculationCoefficients->OnCurveTableChanged().AddUObject(this, &UCharacterClassInfo::RebakeDamageCalculationCoefficients);
+		}
+		BoundCoefficientsTable = DamageCalculationCoefficients;
+	}
+#endif
+
+	const TArray<const FRealCurve*> Curves = FindDamageCalculationCoefficientCurves(OutErrors);
+
+	// Bake far enough to cover every key, so clamping to the last entry matches the curves' constant extrapolation
+	int32 NumLevels = FMath::Max(MaxCoefficientLevel, 1);
+	for (const FRealCurve* Curve : Curves)
+	{
+		if (Curve)
+		{
+			float MinTime = 0.f;
+			float MaxTime = 0.f;
+			Curve->GetTimeRange(MinTime, MaxTime);
+			NumLevels = FMath::Max(NumLevels, FMath::CeilToInt32(MaxTime));
+		}
+	}
+
+	// A missing curve bakes zeros, the lookups never touch the curve table
+	TArray<float>* Tables[] = { &ArmorPenetrationCoefficients, &EffectiveArmorCoefficients, &CriticalHitResistanceCoefficients };
+	for (int32 CurveIndex = 0; CurveIndex < UE_ARRAY_COUNT(Tables); ++CurveIndex)
+	{
+		TArray<float>& Table = *Tables[CurveIndex];
+		Table.SetNumZeroed(NumLevels);
+		if (const FRealCurve* Curve = Curves[CurveIndex])
+		{
+			for (int32 LevelIndex = 0; LevelIndex < NumLevels; ++LevelIndex)
+			{
+				Table[LevelIndex] = Curve->Eval(LevelIndex + 1);
+			}
+		}
+	}
+	return OutErrors.IsEmpty();
+}
@@ -0,0 +1,172 @@
+// Giorjorio Copyright
+
+
+#include "AbilitySystem/ExecCalc/AuraDamageKernel.h"
+
+/*
+ * Every multiply and add below is its own statement on purpose: the compiler may only fuse them into an FMA within
+ * a single expression, and a fused result would no longer match the wide kernel bit for bit.
+ * Clamps are written as compare + select in both kernels instead of FMath::Clamp / VectorMin / VectorMax, whose NaN
+ * handling differs (and differs between platforms for the vector versions). An ordered compare is false for NaN,
+ * so a NaN resistance clamps to 0 in both kernels.
+ */
+
+// Scalar twin of ClampResistanceWide
+static float ClampResistance(float Resistance)
+{
+	const float AboveZero = Resistance > 0.f ? Resistance : 0.f;
+	return AboveZero < 100.f ? AboveZero : 100.f;
+}
+
+// Vector twin of ClampResistance
+static VectorRegister4Float ClampResistanceWide(const VectorRegister4Float& Resistance, const VectorRegister4Float& Zero, const VectorRegister4Float& Hundred)
+{
+	const VectorRegister4Float AboveZero = VectorSelect(VectorCompareGT(Resistance, Zero), Resistance, Zero);
+	return VectorSelect(VectorCompareLT(AboveZero, Hundred), AboveZero, Hundred);
+}
+
+void FAuraDamageBatch::Reset(int32 InNumDamageTypes, int32 ExpectedRows)
+{
+	check(InNumDamageTypes >= 0 && InNumDamageTypes <= AuraDamageKernel::MaxDamageTypes);
+	NumDamageTypes = InNumDamageTypes;
+
+	for (int32 TypeIndex = 0; TypeIndex < AuraDamageKernel::MaxDamageTypes; ++TypeIndex)
+	{
+		DamageByType[TypeIndex].Reset(TypeIndex < NumDamageTypes ? ExpectedRows : 0);
+		ResistanceByType[TypeIndex].Reset(TypeIndex < NumDamageTypes ? ExpectedRows : 0);
+	}
+	ArmorPenetration.Reset(ExpectedRows);
+	ArmorPenetrationCoefficient.Reset(ExpectedRows);
+	Armor.Reset(ExpectedRows);
+	EffectiveArmorCoefficient.Reset(ExpectedRows);
+	CriticalHitDamage.Reset(ExpectedRows);
+	Blocked.Reset(ExpectedRows);
+	Critical.Reset(ExpectedRows);
+}
+
+int32 FAuraDamageBatch::Add(const FAuraDamageSourceValues& Source, const FAuraDamageTargetValues& Target, bool bBlocked, bool bCritical)
+{
+	checkf(Source.NumDamageTypes == NumDamageTypes, TEXT("FAuraDamageBatch expects %d damage types, got %d"), NumDamageTypes, Source.NumDamageTypes);
+
+	for (int32 TypeIndex = 0; TypeIndex < NumDamageTypes; ++TypeIndex)
+	{
+		DamageByType[TypeIndex].Add(Source.DamageByType[TypeIndex]);
+		ResistanceByType[TypeIndex].Add(Target.ResistanceByType[TypeIndex]);
+	}
+	ArmorPenetration.Add(Source.ArmorPenetration);
+	ArmorPenetrationCoefficient.Add(Source.ArmorPenetrationCoefficient);
+	Armor.Add(Target.Armor);
+	EffectiveArmorCoefficient.Add(Target.EffectiveArmorCoefficient);
+	CriticalHitDamage.Add(Source.CriticalHitDamage);
+	Blocked.Add(bBlocked ? 1.f : 0.f);
+	return Critical.Add(bCritical ? 1.f : 0.f);
+}
+
+float AuraDamageKernel::CalculateEffectiveCriticalHitChance(const FAuraDamageSourceValues& Source, const FAuraDamageTargetValues& Target)
+{
+	return Source.CriticalHitChance * (100 - Target.CriticalHitResistance * Target.CriticalHitResistanceCoefficient) / 100.f;
+}
+
+float AuraDamageKernel::CalculateDamage(const FAuraDamageSourceValues& Source, const FAuraDamageTargetValues& Target, bool bBlocked, bool bCritical)
+{
+	// Each damage type is reduced by its matching resistance
+	float Damage = 0.f;
+	for (int32 TypeIndex = 0; TypeIndex < Source.NumDamageTypes; ++TypeIndex)
+	{
+		const float Resistance = ClampResistance(Target.ResistanceByType[TypeIndex]);
+		const float ResistanceFactor = (100.f - Resistance) / 100.f;
+		const float DamageTypeValue = Source.DamageByType[TypeIndex] * ResistanceFactor;
+		Damage += DamageTypeValue;
+	}
+
+	// If Block, halve the damage.
+	Damage = bBlocked ? Damage / 2.f : Damage;
+
+	// ArmorPenetration ignores a percentage of the Target's Armor.
+	const float ArmorIgnored = Source.ArmorPenetration * Source.ArmorPenetrationCoefficient;
+	const float ArmorKept = Target.Armor * (100.f - ArmorIgnored);
+	const float EffectiveArmor = ArmorKept / 100.f;
+
+	// Armor ignores a percentage of incoming Damage.
+	const float DamageIgnored = EffectiveArmor * Target.EffectiveArmorCoefficient;
+	const float ArmorFactor = (100.f - DamageIgnored) / 100.f;
+	Damage *= ArmorFactor;
+
+	// Double the damage plus a bonus if critical hit.
+	if (bCritical)
+	{
+		const float DoubledDamage = Damage * 2.f;
+		Damage = DoubledDamage + Source.CriticalHitDamage;
+	}
+	return Damage;
+}
+
+// Scalar fallback for the rows left over after the last full vector
+static float CalculateDamageRow(const FAuraDamageBatch& Batch, int32 Row)
+{
+	FAuraDamageSourceValues Source;
+	FAuraDamageTargetValues Target;
+	Source.NumDamageTypes = Batch.NumDamageTypes;
+	for (int32 TypeIndex = 0; TypeIndex < Batch.NumDamageTypes; ++TypeIndex)
+	{
+		Source.DamageByType[TypeIndex] = Batch.DamageByType[TypeIndex][Row];
+		Target.ResistanceByType[TypeIndex] = Batch.ResistanceByType[TypeIndex][Row];
+	}
+	Source.ArmorPenetration = Batch.ArmorPenetration[Row];
+	Source.ArmorPenetrationCoefficient = Batch.ArmorPenetrationCoefficient[Row];
+	Source.CriticalHitDamage = Batch.CriticalHitDamage[Row];
+	Target.Armor = Batch.Armor[Row];
+	Target.EffectiveArmorCoefficient = Batch.EffectiveArmorCoefficient[Row];
+
+	return AuraDamageKernel::CalculateDamage(Source, Target, Batch.Blocked[Row] > 0.f, Batch.Critical[Row] > 0.f);
+}
+
+void AuraDamageKernel::CalculateDamageWide(const FAuraDamageBatch& Batch, TArrayView<float> OutDamage)
+{
+	const int32 NumRows = Batch.Num();
+	check(OutDamage.Num() >= NumRows);
+
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float Two = VectorSetFloat1(2.f);
+	const VectorRegister4Float Hundred = VectorSetFloat1(100.f);
+
+	int32 Row = 0;
+	for (; Row + LaneWidth <= NumRows; Row += LaneWidth)
+	{
+		// Each damage type is reduced by its matching resistance
+		VectorRegister4Float Damage = Zero;
+		for (int32 TypeIndex = 0; TypeIndex < Batch.NumDamageTypes; ++TypeIndex)
+		{
+			const VectorRegister4Float Resistance = ClampResistanceWide(VectorLoad(&Batch.ResistanceByType[TypeIndex][Row]), Zero, Hundred);
+			const VectorRegister4Float ResistanceFactor = VectorDivide(VectorSubtract(Hundred, Resistance), Hundred);
+			const VectorRegister4Float DamageTypeValue = VectorMultiply(VectorLoad(&Batch.DamageByType[TypeIndex][Row]), ResistanceFactor);
+			Damage = VectorAdd(Damage, DamageTypeValue);
+		}
+
+		// If Block, halve the damage.
+		const VectorRegister4Float BlockedMask = VectorCompareGT(VectorLoad(&Batch.Blocked[Row]), Zero);
+		Damage = VectorSelect(BlockedMask, VectorDivide(Damage, Two), Damage);
+
+		// ArmorPenetration ignores a percentage of the Target's Armor.
+		const VectorRegister4Float ArmorIgnored = VectorMultiply(VectorLoad(&Batch.ArmorPenetration[Row]), VectorLoad(&Batch.ArmorPenetrationCoefficient[Row]));
+		const VectorRegister4Float ArmorKept = VectorMultiply(VectorLoad(&Batch.Armor[Row]), VectorSubtract(Hundred, ArmorIgnored));
+		const VectorRegister4Float EffectiveArmor = VectorDivide(ArmorKept, Hundred);
+
+		// Armor ignores a percentage of incoming Damage.
+		const VectorRegister4Float DamageIgnored = VectorMultiply(EffectiveArmor, VectorLoad(&Batch.EffectiveArmorCoefficient[Row]));
+		const VectorRegister4Float ArmorFactor = VectorDivide(VectorSubtract(Hundred, DamageIgnored), Hundred);
+		Damage = VectorMultiply(Damage, ArmorFactor);
+
+		// Double the damage plus a bonus if critical hit.
+		const VectorRegister4Float CriticalMask = VectorCompareGT(VectorLoad(&Batch.Critical[Row]), Zero);
+		const VectorRegister4Float CriticalDamage = VectorAdd(VectorMultiply(Damage, Two), VectorLoad(&Batch.CriticalHitDamage[Row]));
+		Damage = VectorSelect(CriticalMask, CriticalDamage, Damage);
+
+		VectorStore(Damage, &OutDamage[Row]);
+	}
+
+	for (; Row < NumRows; ++Row)
+	{
+		OutDamage[Row] = CalculateDamageRow(Batch, Row);
+	}
+}
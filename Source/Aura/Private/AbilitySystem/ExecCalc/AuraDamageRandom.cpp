@@ -0,0 +1,33 @@
+// Giorjorio Copyright
+
+
+#include "AbilitySystem/ExecCalc/AuraDamageRandom.h"
+
+#include "AbilitySystem/AuraAbilitySystemComponent.h"
+#include "HAL/IConsoleManager.h"
+
+static int32 GAuraDamageRandomSeed = 0;
+static FAutoConsoleVariableRef CVarAuraDamageRandomSeed(
+	TEXT("Aura.Damage.RandomSeed"),
+	GAuraDamageRandomSeed,
+	TEXT("Seed mixed into every Block / Critical roll of ExecCalc_Damage, for repeatable runs. 0 (default) uses the seed the server draws for each match."),
+	ECVF_Default);
+
+/** Drawn by the server for each match and replicated by AAuraGameStateBase. */
+static uint32 GAuraDamageMatchSeed = 0;
+
+uint32 AuraDamageRandom::GetSeed()
+{
+	return GAuraDamageRandomSeed != 0 ? static_cast<uint32>(GAuraDamageRandomSeed) : GAuraDamageMatchSeed;
+}
+
+void AuraDamageRandom::SetMatchSeed(uint32 MatchSeed)
+{
+	GAuraDamageMatchSeed = MatchSeed;
+}
+
+uint32 AuraDamageRandom::GetSourceId(const UAbilitySystemComponent* SourceASC)
+{
+	const UAuraAbilitySystemComponent* AuraASC = Cast<UAuraAbilitySystemComponent>(SourceASC);
+	return AuraASC ? AuraASC->GetDamageRollSourceId() : 0;
+}
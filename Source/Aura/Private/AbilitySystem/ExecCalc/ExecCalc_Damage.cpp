@@ -3,12 +3,18 @@
 
 #include "AbilitySystem/ExecCalc/ExecCalc_Damage.h"
 
+#include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
 #include "AuraAbilityTypes.h"
 #include "AuraGameplayTags.h"
+#include "AbilitySystem/AuraAbilitySystemComponent.h"
 #include "AbilitySystem/AuraAbilitySystemLibrary.h"
 #include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/ExecCalc/AuraDamageKernel.h"
+#include "AbilitySystem/ExecCalc/AuraDamageRandom.h"
 #include "AbilitySystem/Data/CharacterClassInfo.h"
+#include "Aura/Aura.h"
+#include "Debug/AuraAllocationCounter.h"
 #include "Interaction/CombatInterface.h"
 
 // Struct for capturing necessary attributes from the target
@@ -26,9 +32,6 @@ struct AuraDamageStatics
 	DECLARE_ATTRIBUTE_CAPTUREDEF(ArcaneResistance); // Declare a capture definition for the ArcaneResistance attribute
 	DECLARE_ATTRIBUTE_CAPTUREDEF(PhysicalResistance); // Declare a capture definition for the PhysicalResistance attribute
 
-	TMap<FGameplayTag, FGameplayEffectAttributeCaptureDefinition> TagsToCaptureDefs; // Map to associate Capture Definitions with GameplayTag
-	
-	
 	AuraDamageStatics()
 	{
 		DEFINE_ATTRIBUTE_CAPTUREDEF(UAuraAttributeSet, Armor, Target, false); // Define how to capture Armor from the target (do not snapshot it)
@@ -42,21 +45,6 @@ struct AuraDamageStatics
 		DEFINE_ATTRIBUTE_CAPTUREDEF(UAuraAttributeSet, LightningResistance, Target, false); // Define how to capture LightningResistance from the target (do not snapshot it)
 		DEFINE_ATTRIBUTE_CAPTUREDEF(UAuraAttributeSet, ArcaneResistance, Target, false); // Define how to capture ArcaneResistance from the target (do not snapshot it)
 		DEFINE_ATTRIBUTE_CAPTUREDEF(UAuraAttributeSet, PhysicalResistance, Target, false); // Define how to capture PhysicalResistance from the target (do not snapshot it)
-
-		const FAuraGameplayTags& Tags = FAuraGameplayTags::Get();
-		// Filling the map
-		TagsToCaptureDefs.Add(Tags.Attributes_Secondary_Armor, ArmorDef);
-		TagsToCaptureDefs.Add(Tags.Attributes_Secondary_BlockChance, BlockChanceDef);
-		TagsToCaptureDefs.Add(Tags.Attributes_Secondary_ArmorPenetration, ArmorPenetrationDef);
-		TagsToCaptureDefs.Add(Tags.Attributes_Secondary_CriticalHitChance, CriticalHitChanceDef);
-		TagsToCaptureDefs.Add(Tags.Attributes_Secondary_CriticalHitDamage, CriticalHitDamageDef);
-		TagsToCaptureDefs.Add(Tags.Attributes_Secondary_CriticalHitResistance, CriticalHitResistanceDef);
-		
-		TagsToCaptureDefs.Add(Tags.Attributes_Resistance_Fire, FireResistanceDef);
-		TagsToCaptureDefs.Add(Tags.Attributes_Resistance_Lightning, LightningResistanceDef);
-		TagsToCaptureDefs.Add(Tags.Attributes_Resistance_Arcane, ArcaneResistanceDef);
-		TagsToCaptureDefs.Add(Tags.Attributes_Resistance_Physical, PhysicalResistanceDef);
-		
 	}
 };
 
@@ -67,6 +55,49 @@ static const AuraDamageStatics& DamageStatics()
 	return DStatics;
 }
 
+// One row per damage type: the SetByCaller tag carrying the damage and the capture definition of its resistance
+struct FAuraDamageTypeCapture
+{
+	FGameplayTag DamageTypeTag;
+	FGameplayEffectAttributeCaptureDefinition ResistanceDef;
+};
+
+// Builds the dense damage type table from DamageTypesToResistances. Runs once, so the map lookups and checks live here instead of in Execute.
+static TArray<FAuraDamageTypeCapture> BuildDamageTypeTable()
+{
+	const FAuraGameplayTags& Tags = FAuraGameplayTags::Get();
+	checkf(Tags.DamageTypesToResistances.Num() > 0, TEXT("ExecCalc_Damage damage type table built before the native Gameplay Tags were initialized"));
+
+	TMap<FGameplayTag, FGameplayEffectAttributeCaptureDefinition> ResistanceTagsToCaptureDefs;
+	ResistanceTagsToCaptureDefs.Add(Tags.Attributes_Resistance_Fire, DamageStatics().FireResistanceDef);
+	ResistanceTagsToCaptureDefs.Add(Tags.Attributes_Resistance_Lightning, DamageStatics().LightningResistanceDef);
+	ResistanceTagsToCaptureDefs.Add(Tags.Attributes_Resistance_Arcane, DamageStatics().ArcaneResistanceDef);
+	ResistanceTagsToCaptureDefs.Add(Tags.Attributes_Resistance_Physical, DamageStatics().PhysicalResistanceDef);
+
+	TArray<FAuraDamageTypeCapture> Table;
+	Table.Reserve(Tags.DamageTypesToResistances.Num());
+	for (const TTuple<FGameplayTag, FGameplayTag>& Pair : Tags.DamageTypesToResistances)
+	{
+		const FGameplayEffectAttributeCaptureDefinition* ResistanceDef = ResistanceTagsToCaptureDefs.Find(Pair.Value);
+		checkf(ResistanceDef, TEXT("No capture definition for Resistance Tag: [%s] in ExecCalc_Damage"), *Pair.Value.ToString());
+		Table.Add({ Pair.Key, *ResistanceDef });
+	}
+	checkf(Table.Num() <= AuraDamageKernel::MaxDamageTypes, TEXT("ExecCalc_Damage supports at most %d damage types, %d are registered"), AuraDamageKernel::MaxDamageTypes, Table.Num());
+	return Table;
+}
+
+// Immutable after the first call, indexed by damage type. Iterating it never allocates.
+static const TArray<FAuraDamageTypeCapture>& DamageTypeTable()
+{
+	static const TArray<FAuraDamageTypeCapture> Table = BuildDamageTypeTable();
+	return Table;
+}
+
+DECLARE_CYCLE_STAT(TEXT("ExecCalc_Damage"), STAT_AuraExecCalcDamage, STATGROUP_Aura);
+DECLARE_CYCLE_STAT(TEXT("ExecCalc_Damage Batch"), STAT_AuraExecCalcDamageBatch, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("ExecCalc_Damage Executions"), STAT_AuraExecCalcDamageExecutions, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("ExecCalc_Damage Heap Allocations"), STAT_AuraExecCalcDamageAllocations, STATGROUP_Aura);
+
 // Constructor: Register the Armor attribute as relevant for this execution calculation
 UExecCalc_Damage::UExecCalc_Damage()
 {
@@ -83,10 +114,91 @@ UExecCalc_Damage::UExecCalc_Damage()
 	RelevantAttributesToCapture.Add(DamageStatics().PhysicalResistanceDef);
 }
 
+void UExecCalc_Damage::InitializeDamageTypeTable()
+{
+	DamageTypeTable();
+}
+
+static int32 GetCombatLevel(AActor* Actor)
+{
+	ICombatInterface* CombatInterface = Cast<ICombatInterface>(Actor);
+	return CombatInterface ? CombatInterface->GetPlayerLevel() : 1;
+}
+
+// Execution index of the Block / Critical rolls of the next execution sourced by SourceASC
+static uint32 ConsumeDamageRollIndex(const UAbilitySystemComponent* SourceASC, const FPredictionKey& PredictionKey)
+{
+	const UAuraAbilitySystemComponent* AuraASC = Cast<UAuraAbilitySystemComponent>(SourceASC);
+	return AuraASC ? AuraASC->ConsumeDamageExecutionIndex(PredictionKey) : 0;
+}
+
+static uint64 MakeDamageRollKey(const UAbilitySystemComponent* SourceASC, const FPredictionKey& PredictionKey, uint32 ExecutionIndex)
+{
+	return AuraDamageRandom::MakeKey(AuraDamageRandom::GetSourceId(SourceASC), PredictionKey.Current, ExecutionIndex);
+}
+
+// Clients only count the executions they predict: the index of the others travels in the replicated context
+static void RecordDamageRollIndex(FGameplayEffectContextHandle& EffectContextHandle, const FPredictionKey& PredictionKey, uint32 ExecutionIndex)
+{
+	if (!PredictionKey.IsValidKey())
+	{
+		static_cast<FAuraGameplayEffectContext*>(EffectContextHandle.Get())->SetDamageRollIndex(ExecutionIndex);
+	}
+}
+
+// Instant IncomingDamage modifier, SetByCaller Damage. Carries the damage ApplyDamageToTargets already resolved.
+static UGameplayEffect* GetResolvedDamageEffect()
+{
+	static UGameplayEffect* Effect = []()
+	{
+		UGameplayEffect* NewEffect = NewObject<UGameplayEffect>(GetTransientPackage(), TEXT("GE_AuraResolvedDamage"));
+		NewEffect->AddToRoot();
+		NewEffect->DurationPolicy = EGameplayEffectDurationType::Instant;
+
+		FSetByCallerFloat DamageMagnitude;
+		DamageMagnitude.DataTag = FAuraGameplayTags::Get().Damage;
+		FGameplayModifierInfo& DamageModifier = NewEffect->Modifiers.AddDefaulted_GetRef();
+		DamageModifier.Attribute = UAuraAttributeSet::GetIncomingDamageAttribute();
+		DamageModifier.ModifierOp = EGameplayModOp::Additive;
+		DamageModifier.ModifierMagnitude = FGameplayEffectModifierMagnitude(DamageMagnitude);
+		return NewEffect;
+	}();
+	return Effect;
+}
+
+// Non-negative source attribute through the aggregator, the way Execute captures it. Uses the spec's capture when it has one.
+static float EvaluateSourceAttribute(const FGameplayEffectSpec& Spec, UAbilitySystemComponent* SourceASC, const FGameplayEffectAttributeCaptureDefinition& CaptureDef, const FAggregatorEvaluateParameters& EvaluationParameters)
+{
+	float Magnitude = 0.f;
+	if (const FGameplayEffectAttributeCaptureSpec* CaptureSpec = Spec.CapturedRelevantAttributes.FindCaptureSpecByDefinition(CaptureDef, true))
+	{
+		CaptureSpec->AttemptCalculateAttributeMagnitude(EvaluationParameters, Magnitude);
+	}
+	else
+	{
+		FGameplayEffectAttributeCaptureSpec NewCaptureSpec(CaptureDef);
+		SourceASC->CaptureAttributeForGameplayEffect(NewCaptureSpec);
+		NewCaptureSpec.AttemptCalculateAttributeMagnitude(EvaluationParameters, Magnitude);
+	}
+	return FMath::Max<float>(Magnitude, 0.f);
+}
+
 // Core logic for applying this GameplayEffect
 void UExecCalc_Damage::Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams,
                                               FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_AuraExecCalcDamage);
+	INC_DWORD_STAT(STAT_AuraExecCalcDamageExecutions);
+
+	// Get the effect specification, which contains data like tags and modifiers
+	const FGameplayEffectSpec& Spec = ExecutionParams.GetOwningSpec();
+
+	// Creating EffectContextHandle
+	FGameplayEffectContextHandle EffectContextHandle = Spec.GetContext();
+
+	// Counts heap allocations made by the damage math below (run with -AuraTrackAllocations). Expected to stay at 0.
+	const FAuraScopedAllocationCounter AllocationCounter;
+	
 	// Get source and target Ability System Components
 	const UAbilitySystemComponent* SourceASC = ExecutionParams.GetSourceAbilitySystemComponent();
 	const UAbilitySystemComponent* TargetASC = ExecutionParams.GetTargetAbilitySystemComponent();
@@ -95,19 +207,9 @@ void UExecCalc_Damage::Execute_Implementation(const FGameplayEffectCustomExecuti
 	AActor* SourceAvatar = SourceASC ? SourceASC->GetAvatarActor() : nullptr;
 	AActor* TargetAvatar = TargetASC ? TargetASC->GetAvatarActor() : nullptr;
 
-	// Get the Damage CurveTable from the Character Class Info of the actor. 
+	// Get the Damage Coefficients from the Character Class Info of the actor. 
 	const UCharacterClassInfo* CharacterClassInfo = UAuraAbilitySystemLibrary::GetCharacterClassInfo(SourceAvatar);
 
-	// Get Combat Interfaces from Source and Target actors
-	ICombatInterface* SourceCombatInterface = Cast<ICombatInterface>(SourceAvatar);
-	ICombatInterface* TargetCombatInterface = Cast<ICombatInterface>(TargetAvatar);
-
-	// Get the effect specification, which contains data like tags and modifiers
-	const FGameplayEffectSpec& Spec = ExecutionParams.GetOwningSpec();
-
-	// Creating EffectContextHandle
-	FGameplayEffectContextHandle EffectContextHandle = Spec.GetContext();
-
 	// Extract source and target tags for conditional calculations
 	const FGameplayTagContainer* SourceTags = Spec.CapturedSourceTags.GetAggregatedTags();
 	const FGameplayTagContainer* TargetTags = Spec.CapturedTargetTags.GetAggregatedTags();
@@ -116,114 +218,180 @@ void UExecCalc_Damage::Execute_Implementation(const FGameplayEffectCustomExecuti
 	FAggregatorEvaluateParameters EvaluationParameters;
 	EvaluationParameters.SourceTags = SourceTags;
 	EvaluationParameters.TargetTags = TargetTags;
+
+	// Captures a non-negative attribute value
+	auto CaptureAttribute = [&ExecutionParams, &EvaluationParameters](const FGameplayEffectAttributeCaptureDefinition& CaptureDef)
+	{
+		float Magnitude = 0.f;
+		ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(CaptureDef, EvaluationParameters, Magnitude);
+		return FMath::Max<float>(Magnitude, 0.f);
+	};
+
+	FAuraDamageSourceValues Source;
+	FAuraDamageTargetValues Target;
 	
-	// Get Damage Set by Caller Magnitude
-	float Damage = 0.f;
-	for (const TTuple<FGameplayTag, FGameplayTag>& Pair : FAuraGameplayTags::Get().DamageTypesToResistances)
+	// Get Damage Set by Caller Magnitude and the matching Resistance for each damage type
+	const TArray<FAuraDamageTypeCapture>& DamageTypes = DamageTypeTable();
+	Source.NumDamageTypes = DamageTypes.Num();
+	for (int32 TypeIndex = 0; TypeIndex < DamageTypes.Num(); ++TypeIndex)
 	{
-		const FGameplayTag DamageTypeTag = Pair.Key;
-		const FGameplayTag ResistanceTag = Pair.Value;
-		
-		checkf(AuraDamageStatics().TagsToCaptureDefs.Contains(ResistanceTag), TEXT("TagsToCaptureDefs doesn't contain Tag: [%s] in ExecCalc_Damage"), *ResistanceTag.ToString());
-		const FGameplayEffectAttributeCaptureDefinition CaptureDef = AuraDamageStatics().TagsToCaptureDefs[ResistanceTag];
-
-		float DamageTypeValue = Spec.GetSetByCallerMagnitude(DamageTypeTag);
-		
-		float Resistance = 0.f;
-		ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(CaptureDef, EvaluationParameters, Resistance);
-		Resistance = FMath::Clamp(Resistance, 0.f, 100.f);
-
-		DamageTypeValue *= (100.f - Resistance) / 100.f;
-		
-		Damage += DamageTypeValue;
+		// Not every ability deals every damage type, so a missing magnitude is expected and not worth a warning
+		Source.DamageByType[TypeIndex] = Spec.GetSetByCallerMagnitude(DamageTypes[TypeIndex].DamageTypeTag, false);
+		ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageTypes[TypeIndex].ResistanceDef, EvaluationParameters, Target.ResistanceByType[TypeIndex]);
 	}
 
-	/*
-	 * Block Chance
-	 */
-	// Capture Block Chance on Target, and determine if there was a successful Block
-	float TargetBlockChance = 0.f;
-	
-	// Try to calculate the current value of the target's Armor attribute
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().BlockChanceDef, EvaluationParameters, TargetBlockChance);
-	TargetBlockChance = FMath::Max<float>(TargetBlockChance, 0.f);  // Ensure BlockChance is at least 0 to avoid negative values
+	/* Source: Armor Penetration, Critical Hit Chance, Critical Hit Damage */
+	Source.ArmorPenetration = CaptureAttribute(DamageStatics().ArmorPenetrationDef);
+	Source.ArmorPenetrationCoefficient = CharacterClassInfo->GetArmorPenetrationCoefficient(GetCombatLevel(SourceAvatar));
+	Source.CriticalHitChance = CaptureAttribute(DamageStatics().CriticalHitChanceDef);
+	Source.CriticalHitDamage = CaptureAttribute(DamageStatics().CriticalHitDamageDef);
+
+	/* Target: Armor, Block Chance, Critical Hit Resistance */
+	const int32 TargetLevel = GetCombatLevel(TargetAvatar);
+	Target.Armor = CaptureAttribute(DamageStatics().ArmorDef);
+	Target.EffectiveArmorCoefficient = CharacterClassInfo->GetEffectiveArmorCoefficient(TargetLevel);
+	Target.BlockChance = CaptureAttribute(DamageStatics().BlockChanceDef);
+	Target.CriticalHitResistance = CaptureAttribute(DamageStatics().CriticalHitResistanceDef);
+	Target.CriticalHitResistanceCoefficient = CharacterClassInfo->GetCriticalHitResistanceCoefficient(TargetLevel);
+
+	// Deterministic rolls: the owning client can reproduce them for the same predicted execution
+	const FPredictionKey& PredictionKey = ExecutionParams.GetPredictionKey();
+	const uint32 RollIndex = ConsumeDamageRollIndex(SourceASC, PredictionKey);
+	RecordDamageRollIndex(EffectContextHandle, PredictionKey, RollIndex);
+	const uint64 RollKey = MakeDamageRollKey(SourceASC, PredictionKey, RollIndex);
 
 	// Determine whether Hit is blocked or not
-	const bool bBlocked = FMath::FRandRange(UE_SMALL_NUMBER, 100.0f) <= TargetBlockChance;
+	const bool bBlocked = AuraDamageRandom::RollPercent(RollKey, AuraDamageRandom::EStream::Block) <= Target.BlockChance;
+
+	// Check whether hit is Critical or not 
+	const bool bCritical = AuraDamageRandom::RollPercent(RollKey, AuraDamageRandom::EStream::Critical) <= AuraDamageKernel::CalculateEffectiveCriticalHitChance(Source, Target);
 
-	// Pass the information to EffectContextHandle whether Hit is blocked or not
+	// Pass the information to EffectContextHandle whether Hit is blocked or critical
 	UAuraAbilitySystemLibrary::SetIsBlockedHit(EffectContextHandle, bBlocked);
-	
-	// If Block, halve the damage.
-	Damage = bBlocked ? Damage / 2.f : Damage; 
+	UAuraAbilitySystemLibrary::SetIsCriticalHit(EffectContextHandle, bCritical);
 
-	/*
-	 * Armor, Armor Penetration
-	*/
-	float TargetArmor = 0.f;
-	
-	// Try to calculate the current value of the target's Armor attribute
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().ArmorDef, EvaluationParameters, TargetArmor);
-	TargetArmor = FMath::Max<float>(TargetArmor, 0.f);  // Ensure Armor is at least 0 to avoid negative values
+	const float Damage = AuraDamageKernel::CalculateDamage(Source, Target, bBlocked, bCritical);
 
-	float SourceArmorPenetration = 0.f;
+	// The output modifier array below belongs to GAS, so it is left out of the count. Reported through "stat Aura" only: this is the hot path.
+	INC_DWORD_STAT_BY(STAT_AuraExecCalcDamageAllocations, AllocationCounter.GetNumAllocations());
 	
-	// Try to calculate the current value of the target's Armor attribute.
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().ArmorPenetrationDef, EvaluationParameters, SourceArmorPenetration);
-	SourceArmorPenetration = FMath::Max<float>(SourceArmorPenetration, 0.f);  // Ensure ArmorPenetration is at least 0 to avoid negative values.
-	
-	// Get the ArmorPenetration Curve and evaluate it with current player level
-	const FRealCurve* ArmorPenetrationCurve = CharacterClassInfo->DamageCalculationCoefficients->FindCurve(FName("ArmorPenetration"), FString());
-	const float ArmorPenetrationCoefficient = ArmorPenetrationCurve->Eval(SourceCombatInterface->GetPlayerLevel());
-	
-	// ArmorPenetration ignores a percentage of the Target's Armor.
-	const float EffectiveArmor = TargetArmor * (100 - SourceArmorPenetration * ArmorPenetrationCoefficient) / 100.f;
+	// Create the output data: apply this Damage value additively
+	const FGameplayModifierEvaluatedData EvaluatedData(UAuraAttributeSet::GetIncomingDamageAttribute(), EGameplayModOp::Additive, Damage);
+
+	// Send this result to the execution output
+	OutExecutionOutput.AddOutputModifier(EvaluatedData);
 	
-	// Get the EffectiveArmor Curve and evaluate it with current player level
-	const FRealCurve* EffectiveArmorCurve = CharacterClassInfo->DamageCalculationCoefficients->FindCurve(FName("EffectiveArmor"), FString());
-	const float EffectiveArmorCoefficient = EffectiveArmorCurve->Eval(TargetCombatInterface->GetPlayerLevel());
+}
+
+void UExecCalc_Damage::ApplyDamageToTargets(const FGameplayEffectSpecHandle& DamageSpecHandle, const TArray<AActor*>& Targets)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AuraExecCalcDamageBatch);
 	
-	// Armor ignores a percentage of incoming Damage.
-	Damage *= (100 - EffectiveArmor * EffectiveArmorCoefficient) / 100.f;
+	if (!DamageSpecHandle.IsValid() || Targets.IsEmpty()) return;
+	const FGameplayEffectSpec& Spec = *DamageSpecHandle.Data;
+
+	UAbilitySystemComponent* SourceASC = Spec.GetContext().GetInstigatorAbilitySystemComponent();
+	if (!IsValid(SourceASC)) return;
+	AActor* SourceAvatar = SourceASC->GetAvatarActor();
 
+	const UCharacterClassInfo* CharacterClassInfo = UAuraAbilitySystemLibrary::GetCharacterClassInfo(SourceAvatar);
+	if (CharacterClassInfo == nullptr) return;
 
 	/*
-	 * Critical Hit Chance, Bonus Damage, Resistance
+	 * Source side, once for the whole batch, with the spec's tags like Execute.
+	 * Target tag requirements see the tags the spec captured so far: the batch shares one evaluation for every target.
 	 */
-	// Critical Hit Chance
-	float SourceCriticalHitChance = 0.f;
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().CriticalHitChanceDef, EvaluationParameters, SourceCriticalHitChance);
-	SourceCriticalHitChance = FMath::Max<float>(SourceCriticalHitChance, 0.f); 
-
-	// Critical Hit Damage
-	float SourceCriticalHitDamage = 0.f;
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().CriticalHitDamageDef, EvaluationParameters, SourceCriticalHitDamage);
-	SourceCriticalHitDamage = FMath::Max<float>(SourceCriticalHitDamage, 0.f);
-
-	// Critical Hit Resistance
-	float TargetCriticalHitResistance = 0.f;
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().CriticalHitResistanceDef, EvaluationParameters, TargetCriticalHitResistance);
-	TargetCriticalHitResistance = FMath::Max<float>(TargetCriticalHitResistance, 0.f);
-	const FRealCurve* CriticalHitResistanceCurve = CharacterClassInfo->DamageCalculationCoefficients->FindCurve(FName("CriticalHitResistance"), FString());
-	const float CriticalHitResistanceCoefficient = CriticalHitResistanceCurve->Eval(TargetCombatInterface->GetPlayerLevel());
-
-	// Critical Hit Resistance reduces a percentage of the Source's Critical Hit Chance.
-	const float EffectiveCriticalHitChance = SourceCriticalHitChance * (100 - TargetCriticalHitResistance * CriticalHitResistanceCoefficient) / 100.f;
-	
-	// Check whether hit is Critical or not 
-	const bool bCritical = FMath::FRandRange(UE_SMALL_NUMBER, 100.0f) <= EffectiveCriticalHitChance;
+	FAggregatorEvaluateParameters EvaluationParameters;
+	EvaluationParameters.SourceTags = Spec.CapturedSourceTags.GetAggregatedTags();
+	EvaluationParameters.TargetTags = Spec.CapturedTargetTags.GetAggregatedTags();
 
-	// Pass the information to EffectContextHandle whether hit is Critical or not 
-	UAuraAbilitySystemLibrary::SetIsCriticalHit(EffectContextHandle, bCritical);
+	const TArray<FAuraDamageTypeCapture>& DamageTypes = DamageTypeTable();
+	FAuraDamageSourceValues Source;
+	Source.NumDamageTypes = DamageTypes.Num();
+	for (int32 TypeIndex = 0; TypeIndex < DamageTypes.Num(); ++TypeIndex)
+	{
+		Source.DamageByType[TypeIndex] = Spec.GetSetByCallerMagnitude(DamageTypes[TypeIndex].DamageTypeTag, false);
+	}
+	Source.ArmorPenetration = EvaluateSourceAttribute(Spec, SourceASC, DamageStatics().ArmorPenetrationDef, EvaluationParameters);
+	Source.ArmorPenetrationCoefficient = CharacterClassInfo->GetArmorPenetrationCoefficient(GetCombatLevel(SourceAvatar));
+	Source.CriticalHitChance = EvaluateSourceAttribute(Spec, SourceASC, DamageStatics().CriticalHitChanceDef, EvaluationParameters);
+	Source.CriticalHitDamage = EvaluateSourceAttribute(Spec, SourceASC, DamageStatics().CriticalHitDamageDef, EvaluationParameters);
+
+	/* Target side: gather every valid target and roll Block / Critical */
+	const FPredictionKey PredictionKey = SourceASC->ScopedPredictionKey;
+	TArray<UAbilitySystemComponent*, TInlineAllocator<16>> TargetASCs;
+	TArray<uint32, TInlineAllocator<16>> RollIndices;
+	FAuraDamageBatch Batch;
+	Batch.Reset(DamageTypes.Num(), Targets.Num());
+	for (AActor* TargetActor : Targets)
+	{
+		UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(TargetActor);
+		if (!IsValid(TargetASC)) continue;
 
-	// Double the damage plus a bonus if critical hit.
-	Damage = bCritical ? Damage * 2.f + SourceCriticalHitDamage : Damage; 
-	
-	
-	// Create the output data: apply this Armor value additively
-	const FGameplayModifierEvaluatedData EvaluatedData(UAuraAttributeSet::GetIncomingDamageAttribute(), EGameplayModOp::Additive, Damage);
+		FAuraDamageTargetValues Target;
+		ReadTargetValues(TargetASC, GetCombatLevel(TargetASC->GetAvatarActor()), CharacterClassInfo, Target);
 
-	// Send this result to the execution output
-	OutExecutionOutput.AddOutputModifier(EvaluatedData);
-	
+		const uint32 RollIndex = ConsumeDamageRollIndex(SourceASC, PredictionKey);
+		const uint64 RollKey = MakeDamageRollKey(SourceASC, PredictionKey, RollIndex);
+		const bool bBlocked = AuraDamageRandom::RollPercent(RollKey, AuraDamageRandom::EStream::Block) <= Target.BlockChance;
+		const bool bCritical = AuraDamageRandom::RollPercent(RollKey, AuraDamageRandom::EStream::Critical) <= AuraDamageKernel::CalculateEffectiveCriticalHitChance(Source, Target);
+
+		Batch.Add(Source, Target, bBlocked, bCritical);
+		TargetASCs.Add(TargetASC);
+		RollIndices.Add(RollIndex);
+	}
+
+	/* Damage for the whole batch at once */
+	TArray<float, TInlineAllocator<16>> Damage;
+	Damage.SetNumUninitialized(Batch.Num());
+	AuraDamageKernel::CalculateDamageWide(Batch, Damage);
+
+	/*
+	 * One instant modifier spec for every target, carrying its resolved damage. The attribute set reads the
+	 * Block/Critical flags while the damage executes, so one context is enough, updated before each target.
+	 */
+	FGameplayEffectContextHandle ContextHandle(Spec.GetContext().Duplicate());
+	FGameplayEffectSpec ResolvedDamageSpec(GetResolvedDamageEffect(), ContextHandle, Spec.GetLevel());
+	const FGameplayTag& DamageTag = FAuraGameplayTags::Get().Damage;
+	for (int32 Row = 0; Row < Batch.Num(); ++Row)
+	{
+		UAuraAbilitySystemLibrary::SetIsBlockedHit(ContextHandle, Batch.Blocked[Row] > 0.f);
+		UAuraAbilitySystemLibrary::SetIsCriticalHit(ContextHandle, Batch.Critical[Row] > 0.f);
+		RecordDamageRollIndex(ContextHandle, PredictionKey, RollIndices[Row]);
+
+		ResolvedDamageSpec.SetSetByCallerMagnitude(DamageTag, Damage[Row]);
+		SourceASC->ApplyGameplayEffectSpecToTarget(ResolvedDamageSpec, TargetASCs[Row]);
+	}
+}
+
+int32 UExecCalc_Damage::FindDamageTypeIndex(const FGameplayTag& DamageTypeTag)
+{
+	return DamageTypeTable().IndexOfByPredicate([&DamageTypeTag](const FAuraDamageTypeCapture& DamageTypeCapture)
+	{
+		return DamageTypeCapture.DamageTypeTag == DamageTypeTag;
+	});
+}
+
+void UExecCalc_Damage::ReadSourceValues(const UAbilitySystemComponent* SourceASC, int32 SourceLevel, const UCharacterClassInfo* CharacterClassInfo, FAuraDamageSourceValues& OutSource)
+{
+	// Same clamping as the captures in Execute
+	OutSource.NumDamageTypes = DamageTypeTable().Num();
+	OutSource.ArmorPenetration = FMath::Max<float>(SourceASC->GetNumericAttribute(UAuraAttributeSet::GetArmorPenetrationAttribute()), 0.f);
+	OutSource.ArmorPenetrationCoefficient = CharacterClassInfo->GetArmorPenetrationCoefficient(SourceLevel);
+	OutSource.CriticalHitChance = FMath::Max<float>(SourceASC->GetNumericAttribute(UAuraAttributeSet::GetCriticalHitChanceAttribute()), 0.f);
+	OutSource.CriticalHitDamage = FMath::Max<float>(SourceASC->GetNumericAttribute(UAuraAttributeSet::GetCriticalHitDamageAttribute()), 0.f);
+}
+
+void UExecCalc_Damage::ReadTargetValues(const UAbilitySystemComponent* TargetASC, int32 TargetLevel, const UCharacterClassInfo* CharacterClassInfo, FAuraDamageTargetValues& OutTarget)
+{
+	const TArray<FAuraDamageTypeCapture>& DamageTypes = DamageTypeTable();
+	for (int32 TypeIndex = 0; TypeIndex < DamageTypes.Num(); ++TypeIndex)
+	{
+		OutTarget.ResistanceByType[TypeIndex] = TargetASC->GetNumericAttribute(DamageTypes[TypeIndex].ResistanceDef.AttributeToCapture);
+	}
+	OutTarget.Armor = FMath::Max<float>(TargetASC->GetNumericAttribute(UAuraAttributeSet::GetArmorAttribute()), 0.f);
+	OutTarget.EffectiveArmorCoefficient = CharacterClassInfo->GetEffectiveArmorCoefficient(TargetLevel);
+	OutTarget.BlockChance = FMath::Max<float>(TargetASC->GetNumericAttribute(UAuraAttributeSet::GetBlockChanceAttribute()), 0.f);
+	OutTarget.CriticalHitResistance = FMath::Max<float>(TargetASC->GetNumericAttribute(UAuraAttributeSet::GetCriticalHitResistanceAttribute()), 0.f);
+	OutTarget.CriticalHitResistanceCoefficient = CharacterClassInfo->GetCriticalHitResistanceCoefficient(TargetLevel);
 }
@@ -3,36 +3,7 @@
 
 #include "AbilitySystem/ModMagCalc/MMC_ArcaneResistance.h"
 
-#include "AbilitySystem/AuraAttributeSet.h"
-
 UMMC_ArcaneResistance::UMMC_ArcaneResistance()
 {
-	IntelligenceDef.AttributeToCapture = UAuraAttributeSet::GetIntelligenceAttribute();
-	IntelligenceDef.AttributeSource = EGameplayEffectAttributeCaptureSource::Target;
-	IntelligenceDef.bSnapshot = false;
-	
-	ResilienceDef.AttributeToCapture = UAuraAttributeSet::GetResilienceAttribute();
-	ResilienceDef.AttributeSource = EGameplayEffectAttributeCaptureSource::Target;
-	ResilienceDef.bSnapshot = false;
-}
-
-float UMMC_ArcaneResistance::CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const
-{
-	// Gather tags from source and target
-	const FGameplayTagContainer* SourceTags = Spec.CapturedSourceTags.GetAggregatedTags();
-	const FGameplayTagContainer* TargetTags = Spec.CapturedTargetTags.GetAggregatedTags();
-	
-	FAggregatorEvaluateParameters EvaluationParameters;
-	EvaluationParameters.SourceTags = SourceTags;
-	EvaluationParameters.TargetTags = TargetTags;
-
-	float Intelligence = 0.f;
-	GetCapturedAttributeMagnitude(IntelligenceDef, Spec, EvaluationParameters, Intelligence);
-	Intelligence = FMath::Max<float>(Intelligence, 0.0f);
-
-	float Resilience = 0.f;
-	GetCapturedAttributeMagnitude(ResilienceDef, Spec, EvaluationParameters, Resilience);
-	Resilience = FMath::Max<float>(Resilience, 0.0f);
-	
-	return ((Resilience * 0.5f + Intelligence * 2.f) * 0.5f) + 0.75f;
+	SetDerivedAttribute(EAuraDerivedAttribute::ArcaneResistance);
 }
@@ -0,0 +1,134 @@
+// Giorjorio Copyright
+
+
+#include "AbilitySystem/ModMagCalc/MMC_DerivedAttribute.h"
+
+#include "Aura.h"
+#include "AuraGameplayTags.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "Interaction/CombatInterface.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Derived Attribute Calculations"), STAT_AuraDerivedAttributeCalculations, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Derived Attribute Passes"), STAT_AuraDerivedAttributePasses, STATGROUP_Aura);
+
+static constexpr int32 NumDerivedAttributes = static_cast<int32>(EAuraDerivedAttribute::Num);
+
+/* Indexed by EAuraDerivedAttribute */
+static const FAuraDerivedAttributeFormula DerivedAttributeFormulas[NumDerivedAttributes] =
+{
+	//  Resilience, Intelligence, Strength, Vigor, Scale, Level, Constant
+	{ 0.f,  0.f,  0.f, 6.f, 1.f,   8.f,  50.f  }, // MaxHealth
+	{ 0.f,  10.f, 0.f, 0.f, 1.f,   10.f, -30.f }, // MaxMana
+	{ 2.f,  0.5f, 0.f, 0.f, 0.5f,  0.f,  0.75f }, // FireResistance
+	{ 1.f,  1.f,  1.f, 0.f, 0.33f, 0.f,  0.75f }, // LightningResistance
+	{ 0.5f, 2.f,  0.f, 0.f, 0.5f,  0.f,  0.75f }, // ArcaneResistance
+	{ 1.f,  0.f,  1.f, 0.f, 0.5f,  0.f,  0.75f }, // PhysicalResistance
+};
+
+static FGameplayEffectAttributeCaptureDefinition MakeTargetCaptureDefinition(const FGameplayAttribute& Attribute)
+{
+	FGameplayEffectAttributeCaptureDefinition Definition;
+	Definition.AttributeToCapture = Attribute;
+	Definition.AttributeSource = EGameplayEffectAttributeCaptureSource::Target;
+	// Re-evaluations are driven by UAuraAbilitySystemComponent, which coalesces them
+	Definition.bSnapshot = true;
+	return Definition;
+}
+
+void UMMC_DerivedAttribute::SetDerivedAttribute(EAuraDerivedAttribute InDerivedAttribute)
+{
+	DerivedAttribute = InDerivedAttribute;
+
+	const FAuraDerivedAttributeFormula& Formula = GetFormula(DerivedAttribute);
+	auto CaptureIfRead = [this](const FGameplayAttribute& Attribute, float Coefficient)
+	{
+		if (Coefficient != 0.f)
+		{
+			RelevantAttributesToCapture.Add(MakeTargetCaptureDefinition(Attribute));
+		}
+	};
+
+	RelevantAttributesToCapture.Reset();
+	CaptureIfRead(UAuraAttributeSet::GetResilienceAttribute(), Formula.ResilienceCoefficient);
+	CaptureIfRead(UAuraAttributeSet::GetIntelligenceAttribute(), Formula.IntelligenceCoefficient);
+	CaptureIfRead(UAuraAttributeSet::GetStrengthAttribute(), Formula.StrengthCoefficient);
+	CaptureIfRead(UAuraAttributeSet::GetVigorAttribute(), Formula.VigorCoefficient);
+}
+
+const FAuraDerivedAttributeFormula& UMMC_DerivedAttribute::GetFormula(EAuraDerivedAttribute InDerivedAttribute)
+{
+	check(InDerivedAttribute < EAuraDerivedAttribute::Num);
+	return DerivedAttributeFormulas[static_cast<int32>(InDerivedAttribute)];
+}
+
+FGameplayTag UMMC_DerivedAttribute::GetSetByCallerTag(EAuraDerivedAttribute InDerivedAttribute)
+{
+	const FAuraGameplayTags& GameplayTags = FAuraGameplayTags::Get();
+	switch (InDerivedAttribute)
+	{
+	case EAuraDerivedAttribute::MaxHealth: return GameplayTags.Attributes_Secondary_MaxHealth;
+	case EAuraDerivedAttribute::MaxMana: return GameplayTags.Attributes_Secondary_MaxMana;
+	case EAuraDerivedAttribute::FireResistance: return GameplayTags.Attributes_Resistance_Fire;
+	case EAuraDerivedAttribute::LightningResistance: return GameplayTags.Attributes_Resistance_Lightning;
+	case EAuraDerivedAttribute::ArcaneResistance: return GameplayTags.Attributes_Resistance_Arcane;
+	case EAuraDerivedAttribute::PhysicalResistance: return GameplayTags.Attributes_Resistance_Physical;
+	default: return FGameplayTag();
+	}
+}
+
+float UMMC_DerivedAttribute::Evaluate(EAuraDerivedAttribute InDerivedAttribute, const FAuraDerivedAttributeInputs& Inputs)
+{
+	const FAuraDerivedAttributeFormula& Formula = GetFormula(InDerivedAttribute);
+	const float Weighted =
+		Inputs.Resilience * Formula.ResilienceCoefficient +
+		Inputs.Intelligence * Formula.IntelligenceCoefficient +
+		Inputs.Strength * Formula.StrengthCoefficient +
+		Inputs.Vigor * Formula.VigorCoefficient;
+	return Weighted * Formula.Scale + Inputs.Level * Formula.LevelCoefficient + Formula.Constant;
+}
+
+void UMMC_DerivedAttribute::EvaluateAll(const FAuraDerivedAttributeInputs& Inputs, float (&OutValues)[NumDerivedAttributes])
+{
+	INC_DWORD_STAT(STAT_AuraDerivedAttributePasses);
+
+	for (int32 Index = 0; Index < NumDerivedAttributes; ++Index)
+	{
+		OutValues[Index] = Evaluate(static_cast<EAuraDerivedAttribute>(Index), Inputs);
+	}
+}
+
+float UMMC_DerivedAttribute::CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const
+{
+	INC_DWORD_STAT(STAT_AuraDerivedAttributeCalculations);
+
+	// Re-evaluation by UAuraAbilitySystemComponent::FlushDerivedAttributes, from its pass over the target
+	if (const float* Value = Spec.SetByCallerTagMagnitudes.Find(GetSetByCallerTag(DerivedAttribute)))
+	{
+		return *Value;
+	}
+
+	// On application, from the captures. Gather tags from source and target
+	FAggregatorEvaluateParameters EvaluationParameters;
+	EvaluationParameters.SourceTags = Spec.CapturedSourceTags.GetAggregatedTags();
+	EvaluationParameters.TargetTags = Spec.CapturedTargetTags.GetAggregatedTags();
+
+	FAuraDerivedAttributeInputs Inputs;
+	for (const FGameplayEffectAttributeCaptureDefinition& Definition : RelevantAttributesToCapture)
+	{
+		float Magnitude = 0.f;
+		GetCapturedAttributeMagnitude(Definition, Spec, EvaluationParameters, Magnitude);
+		Magnitude = FMath::Max<float>(Magnitude, 0.f);
+
+		if (Definition.AttributeToCapture == UAuraAttributeSet::GetStrengthAttribute()) Inputs.Strength = Magnitude;
+		else if (Definition.AttributeToCapture == UAuraAttributeSet::GetIntelligenceAttribute()) Inputs.Intelligence = Magnitude;
+		else if (Definition.AttributeToCapture == UAuraAttributeSet::GetResilienceAttribute()) Inputs.Resilience = Magnitude;
+		else if (Definition.AttributeToCapture == UAuraAttributeSet::GetVigorAttribute()) Inputs.Vigor = Magnitude;
+	}
+
+	if (ICombatInterface* CombatInterface = Cast<ICombatInterface>(Spec.GetContext().GetSourceObject()))
+	{
+		Inputs.Level = CombatInterface->GetPlayerLevel();
+	}
+
+	return Evaluate(DerivedAttribute, Inputs);
+}
@@ -3,42 +3,7 @@
 
 #include "AbilitySystem/ModMagCalc/MMC_FireResistance.h"
 
-#include "AuraGameplayTags.h"
-#include "AbilitySystem/AuraAttributeSet.h"
-
-
 UMMC_FireResistance::UMMC_FireResistance()
 {
-	IntelligenceDef.AttributeToCapture = UAuraAttributeSet::GetIntelligenceAttribute();
-	IntelligenceDef.AttributeSource = EGameplayEffectAttributeCaptureSource::Target;
-	IntelligenceDef.bSnapshot = false;
-	
-	ResilienceDef.AttributeToCapture = UAuraAttributeSet::GetResilienceAttribute();
-	ResilienceDef.AttributeSource = EGameplayEffectAttributeCaptureSource::Target;
-	ResilienceDef.bSnapshot = false;
-	
-	RelevantAttributesToCapture.Add(IntelligenceDef);
-	RelevantAttributesToCapture.Add(ResilienceDef);
-}
-
-float UMMC_FireResistance::CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const
-{
-	// Gather tags from source and target
-	const FGameplayTagContainer* SourceTags = Spec.CapturedSourceTags.GetAggregatedTags();
-	const FGameplayTagContainer* TargetTags = Spec.CapturedTargetTags.GetAggregatedTags();
-	
-	FAggregatorEvaluateParameters EvaluationParameters;
-	EvaluationParameters.SourceTags = SourceTags;
-	EvaluationParameters.TargetTags = TargetTags;
-
-	float Intelligence = 0.f;
-	GetCapturedAttributeMagnitude(IntelligenceDef, Spec, EvaluationParameters, Intelligence);
-	Intelligence = FMath::Max<float>(Intelligence, 0.0f);
-
-	float Resilience = 0.f;
-	GetCapturedAttributeMagnitude(ResilienceDef, Spec, EvaluationParameters, Resilience);
-	Resilience = FMath::Max<float>(Resilience, 0.0f);
-	
-	return ((Resilience * 2.f + Intelligence * 0.5f ) * 0.5f) + 0.75f;
-	
+	SetDerivedAttribute(EAuraDerivedAttribute::FireResistance);
 }
@@ -3,48 +3,7 @@
 
 #include "AbilitySystem/ModMagCalc/MMC_LightningResistance.h"
 
-#include "AbilitySystem/AuraAttributeSet.h"
-
 UMMC_LightningResistance::UMMC_LightningResistance()
 {
-	IntelligenceDef.AttributeToCapture = UAuraAttributeSet::GetIntelligenceAttribute();
-	IntelligenceDef.AttributeSource = EGameplayEffectAttributeCaptureSource::Target;
-	IntelligenceDef.bSnapshot = false;
-	
-	ResilienceDef.AttributeToCapture = UAuraAttributeSet::GetResilienceAttribute();
-	ResilienceDef.AttributeSource = EGameplayEffectAttributeCaptureSource::Target;
-	ResilienceDef.bSnapshot = false;
-	
-	StrengthDef.AttributeToCapture = UAuraAttributeSet::GetStrengthAttribute();
-	StrengthDef.AttributeSource = EGameplayEffectAttributeCaptureSource::Target;
-	StrengthDef.bSnapshot = false;
-	
-	RelevantAttributesToCapture.Add(IntelligenceDef);
-	RelevantAttributesToCapture.Add(ResilienceDef);
-	RelevantAttributesToCapture.Add(StrengthDef);
-}
-
-float UMMC_LightningResistance::CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const
-{
-	// Gather tags from source and target
-	const FGameplayTagContainer* SourceTags = Spec.CapturedSourceTags.GetAggregatedTags();
-	const FGameplayTagContainer* TargetTags = Spec.CapturedTargetTags.GetAggregatedTags();
-	
-	FAggregatorEvaluateParameters EvaluationParameters;
-	EvaluationParameters.SourceTags = SourceTags;
-	EvaluationParameters.TargetTags = TargetTags;
-
-	float Intelligence = 0.f;
-	GetCapturedAttributeMagnitude(IntelligenceDef, Spec, EvaluationParameters, Intelligence);
-	Intelligence = FMath::Max<float>(Intelligence, 0.0f);
-
-	float Resilience = 0.f;
-	GetCapturedAttributeMagnitude(ResilienceDef, Spec, EvaluationParameters, Resilience);
-	Resilience = FMath::Max<float>(Resilience, 0.0f);
-
-	float Strength = 0.f;
-	GetCapturedAttributeMagnitude(StrengthDef, Spec, EvaluationParameters, Strength);
-	Strength = FMath::Max<float>(Strength, 0.0f);
-
-	return ((Resilience + Intelligence + Strength) * 0.33f) + 0.75f;
+	SetDerivedAttribute(EAuraDerivedAttribute::LightningResistance);
 }
@@ -3,39 +3,7 @@
 
 #include "AbilitySystem/ModMagCalc/MMC_PhysicalResistance.h"
 
-#include "AbilitySystem/AuraAttributeSet.h"
-
 UMMC_PhysicalResistance::UMMC_PhysicalResistance()
 {
-	ResilienceDef.AttributeToCapture = UAuraAttributeSet::GetResilienceAttribute();
-	ResilienceDef.AttributeSource = EGameplayEffectAttributeCaptureSource::Target;
-	ResilienceDef.bSnapshot = false;
-	
-	StrengthDef.AttributeToCapture = UAuraAttributeSet::GetStrengthAttribute();
-	StrengthDef.AttributeSource = EGameplayEffectAttributeCaptureSource::Target;
-	StrengthDef.bSnapshot = false;
-
-	RelevantAttributesToCapture.Add(ResilienceDef);
-	RelevantAttributesToCapture.Add(StrengthDef);
-}
-
-float UMMC_PhysicalResistance::CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const
-{
-	// Gather tags from source and target
-	const FGameplayTagContainer* SourceTags = Spec.CapturedSourceTags.GetAggregatedTags();
-	const FGameplayTagContainer* TargetTags = Spec.CapturedTargetTags.GetAggregatedTags();
-	
-	FAggregatorEvaluateParameters EvaluationParameters;
-	EvaluationParameters.SourceTags = SourceTags;
-	EvaluationParameters.TargetTags = TargetTags;
-
-	float Resilience = 0.f;
-	GetCapturedAttributeMagnitude(ResilienceDef, Spec, EvaluationParameters, Resilience);
-	Resilience = FMath::Max<float>(Resilience, 0.0f);
-
-	float Strength = 0.f;
-	GetCapturedAttributeMagnitude(StrengthDef, Spec, EvaluationParameters, Strength);
-	Strength = FMath::Max<float>(Strength, 0.0f);
-
-	return ((Resilience + Strength) * 0.5f) + 0.75f;
+	SetDerivedAttribute(EAuraDerivedAttribute::PhysicalResistance);
 }
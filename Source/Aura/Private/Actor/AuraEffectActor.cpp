@@ -5,6 +5,8 @@
 
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
+#include "Actor/AuraEffectZoneSubsystem.h"
+#include "Interaction/CombatInterface.h"
 
 
 
@@ -20,12 +22,39 @@ void AAuraEffectActor::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (bUseZoneManager)
+	{
+		// The zone manager replaces the overlaps
+		SetActorEnableCollision(false);
+
+		UAuraEffectZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<UAuraEffectZoneSubsystem>();
+		if (ZoneSubsystem && HasAuthority())
+		{
+			ZoneSubsystem->RegisterZone(this, FBox::BuildAABB(GetActorLocation(), ZoneExtent));
+		}
+	}
+}
+
+void AAuraEffectActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bUseZoneManager)
+	{
+		if (UAuraEffectZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<UAuraEffectZoneSubsystem>())
+		{
+			ZoneSubsystem->UnregisterZone(this);
+		}
+	}
+
+	// Destroyed or unloaded with its level: the targets still inside never get an end overlap
+	RemoveAllActiveEffects();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AAuraEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGameplayEffect> GameplayEffectClass)
 {
 	// Do not apply effect if actor is an enemy
-	if (TargetActor->ActorHasTag(FName("Enemy")) && !bApplyEffectsToEnemies) return;
+	if (!bApplyEffectsToEnemies && EnumHasAnyFlags(ICombatInterface::GetActorTeam(TargetActor), EAuraTeam::Enemies)) return;
 	
 	/* Traditional way to get something from actor 
 	IAbilitySystemInterface* ASCInterface = Cast<IAbilitySystemInterface>(Target);
@@ -48,7 +77,7 @@ void AAuraEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGam
 	const bool bIsInfinite = EffectSpecHandle.Data.Get()->Def.Get()->DurationPolicy == EGameplayEffectDurationType::Infinite;
 	if (bIsInfinite && InfiniteEffectRemovalPolicy == EEffectRemovalPolicy::RemoveOnEndOverlap)
 	{
-		ActiveEffectHandles.Add(ActiveEffectHandle, TargetASC);
+		ActiveEffectHandles.Add(TargetASC, ActiveEffectHandle);
 	}
 
 	if (bDestroyOnEffectApplication && !bIsInfinite)
@@ -62,7 +91,7 @@ void AAuraEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGam
 void AAuraEffectActor::OnOverlap(AActor* TargetActor)
 {
 	// Do not apply effect if actor is an enemy
-	if (TargetActor->ActorHasTag(FName("Enemy")) && !bApplyEffectsToEnemies) return;
+	if (!bApplyEffectsToEnemies && EnumHasAnyFlags(ICombatInterface::GetActorTeam(TargetActor), EAuraTeam::Enemies)) return;
 	
 	if (InstantEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnOverlap)
 	{
@@ -81,7 +110,7 @@ void AAuraEffectActor::OnOverlap(AActor* TargetActor)
 void AAuraEffectActor::OnEndOverlap(AActor* TargetActor)
 {
 	// Do not apply effect if actor is an enemy
-	if (TargetActor->ActorHasTag(FName("Enemy")) && !bApplyEffectsToEnemies) return;
+	if (!bApplyEffectsToEnemies && EnumHasAnyFlags(ICombatInterface::GetActorTeam(TargetActor), EAuraTeam::Enemies)) return;
 	
 	if (InstantEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnEndOverlap)
 	{
@@ -103,20 +132,26 @@ void AAuraEffectActor::OnEndOverlap(AActor* TargetActor)
 		/* Way to remove without using a Map at all. WORKS!
 		TargetASC->RemoveActiveGameplayEffectBySourceEffect(InfiniteGameplayEffectClass, TargetASC, 1);*/
 
-		TArray<FActiveGameplayEffectHandle> HandlesToRemove;
-		for (const auto HandlePair : ActiveEffectHandles)
+		TArray<FActiveGameplayEffectHandle, TInlineAllocator<4>> HandlesToRemove;
+		ActiveEffectHandles.MultiFind(TargetASC, HandlesToRemove);
+		ActiveEffectHandles.Remove(TargetASC);
+		for (const FActiveGameplayEffectHandle& Handle : HandlesToRemove)
 		{
-			if (TargetASC == HandlePair.Value)
-			{
-				TargetASC->RemoveActiveGameplayEffect(HandlePair.Key, 1);
-				HandlesToRemove.Add(HandlePair.Key);
-			}
+			TargetASC->RemoveActiveGameplayEffect(Handle, 1);
 		}
-		for (auto& Handle : HandlesToRemove)
+	}
+}
+
+void AAuraEffectActor::RemoveAllActiveEffects()
+{
+	for (const TPair<TWeakObjectPtr<UAbilitySystemComponent>, FActiveGameplayEffectHandle>& HandlePair : ActiveEffectHandles)
+	{
+		if (UAbilitySystemComponent* TargetASC = HandlePair.Key.Get())
 		{
-			ActiveEffectHandles.FindAndRemoveChecked(Handle);
+			TargetASC->RemoveActiveGameplayEffect(HandlePair.Value, 1);
 		}
 	}
+	ActiveEffectHandles.Empty();
 }
 
 
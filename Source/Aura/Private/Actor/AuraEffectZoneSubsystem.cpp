@@ -0,0 +1,223 @@
+// Giorjorio Copyright
+
+
+#include "Actor/AuraEffectZoneSubsystem.h"
+
+#include "Aura.h"
+#include "EngineUtils.h"
+#include "TimerManager.h"
+#include "Actor/AuraEffectActor.h"
+#include "Character/AuraCharacterBase.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Effect Zones Update"), STAT_AuraEffectZonesUpdate, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effect Zones"), STAT_AuraEffectZones, STATGROUP_Aura);
+
+static float GAuraEffectZonesUpdateRate = 10.f;
+static FAutoConsoleVariableRef CVarAuraEffectZonesUpdateRate(
+	TEXT("Aura.EffectZones.UpdateRate"),
+	GAuraEffectZonesUpdateRate,
+	TEXT("Zone tests per second. Read when the first zone registers."));
+
+static float GAuraEffectZonesCellSize = 1000.f;
+static FAutoConsoleVariableRef CVarAuraEffectZonesCellSize(
+	TEXT("Aura.EffectZones.CellSize"),
+	GAuraEffectZonesCellSize,
+	TEXT("Size of the zone grid cells. Read when the first zone registers."));
+
+void UAuraEffectZoneSubsystem::RegisterZone(AAuraEffectActor* ZoneActor, const FBox& Bounds)
+{
+	check(ZoneActor);
+
+	if (Zones.IsEmpty())
+	{
+		CellSize = FMath::Max(GAuraEffectZonesCellSize, 1.f);
+	}
+
+	FZone Zone;
+	Zone.Actor = ZoneActor;
+	Zone.Bounds = Bounds;
+	Zone.MinCell = GetCell(Bounds.Min);
+	Zone.MaxCell = GetCell(Bounds.Max);
+	const int32 Index = Zones.Add(MoveTemp(Zone));
+
+	for (int32 X = Zones[Index].MinCell.X; X <= Zones[Index].MaxCell.X; ++X)
+	{
+		for (int32 Y = Zones[Index].MinCell.Y; Y <= Zones[Index].MaxCell.Y; ++Y)
+		{
+			Grid.FindOrAdd(FIntPoint(X, Y)).Add(Index);
+		}
+	}
+	INC_DWORD_STAT(STAT_AuraEffectZones);
+
+	if (!UpdateTimer.IsValid())
+	{
+		const float Interval = 1.f / FMath::Max(GAuraEffectZonesUpdateRate, 1.f);
+		GetWorld()->GetTimerManager().SetTimer(UpdateTimer, FTimerDelegate::CreateUObject(this, &UAuraEffectZoneSubsystem::UpdateZones), Interval, true);
+	}
+}
+
+void UAuraEffectZoneSubsystem::UnregisterZone(AAuraEffectActor* ZoneActor)
+{
+	for (TSparseArray<FZone>::TIterator It(Zones); It; ++It)
+	{
+		if (It->Actor != ZoneActor)
+		{
+			continue;
+		}
+
+		for (int32 X = It->MinCell.X; X <= It->MaxCell.X; ++X)
+		{
+			for (int32 Y = It->MinCell.Y; Y <= It->MaxCell.Y; ++Y)
+			{
+				const FIntPoint Cell(X, Y);
+				TArray<int32>& CellZones = Grid.FindChecked(Cell);
+				CellZones.RemoveSingleSwap(It.GetIndex(), EAllowShrinking::No);
+				if (CellZones.IsEmpty())
+				{
+					Grid.Remove(Cell);
+				}
+			}
+		}
+		It.RemoveCurrent();
+		DEC_DWORD_STAT(STAT_AuraEffectZones);
+
+		// Nothing left to test, the next registration starts the timer again
+		if (Zones.IsEmpty())
+		{
+			GetWorld()->GetTimerManager().ClearTimer(UpdateTimer);
+		}
+		return;
+	}
+}
+
+void UAuraEffectZoneSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(UpdateTimer);
+	}
+	Super::Deinitialize();
+}
+
+bool UAuraEffectZoneSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAuraEffectZoneSubsystem::UpdateZones()
+{
+	SCOPE_CYCLE_COUNTER(STAT_AuraEffectZonesUpdate);
+
+	if (Zones.IsEmpty())
+	{
+		return;
+	}
+
+	// Occupants of this update, by zone index
+	TMap<int32, TArray<AActor*, TInlineAllocator<8>>> Inside;
+	TArray<int32, TInlineAllocator<8>> TestedZones;
+	for (AAuraCharacterBase* Combatant : TActorRange<AAuraCharacterBase>(GetWorld()))
+	{
+		// The capsule touches a zone when its center is inside the zone inflated by the capsule's extent
+		float Radius = 0.f;
+		float HalfHeight = 0.f;
+		Combatant->GetCapsuleComponent()->GetScaledCapsuleSize(Radius, HalfHeight);
+		const FVector Extent(Radius, Radius, HalfHeight);
+		const FVector Location = Combatant->GetActorLocation();
+
+		// The capsule can reach into the neighbouring cells, a zone in several of them is tested once
+		TestedZones.Reset();
+		const FIntPoint MinCell = GetCell(Location - Extent);
+		const FIntPoint MaxCell = GetCell(Location + Extent);
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				const TArray<int32>* CellZones = Grid.Find(FIntPoint(X, Y));
+				if (!CellZones)
+				{
+					continue;
+				}
+				for (const int32 Index : *CellZones)
+				{
+					if (TestedZones.Contains(Index))
+					{
+						continue;
+					}
+					TestedZones.Add(Index);
+					if (Zones[Index].Bounds.ExpandBy(Extent).IsInsideOrOn(Location))
+					{
+						Inside.FindOrAdd(Index).Add(Combatant);
+					}
+				}
+			}
+		}
+	}
+
+	// Collected first, the callbacks may destroy zones
+	struct FZoneEvent
+	{
+		TWeakObjectPtr<AAuraEffectActor> Zone;
+		TWeakObjectPtr<AActor> Combatant;
+		bool bEnter;
+	};
+	TArray<FZoneEvent> Events;
+
+	for (TSparseArray<FZone>::TIterator It(Zones); It; ++It)
+	{
+		FZone& Zone = *It;
+		const TArray<AActor*, TInlineAllocator<8>>* Current = Inside.Find(It.GetIndex());
+		if (!Current && Zone.Occupants.IsEmpty())
+		{
+			continue;
+		}
+
+		for (const TWeakObjectPtr<AActor>& Occupant : Zone.Occupants)
+		{
+			if (Occupant.IsValid() && (!Current || !Current->Contains(Occupant.Get())))
+			{
+				Events.Add({ Zone.Actor, Occupant, false });
+			}
+		}
+
+		TArray<TWeakObjectPtr<AActor>> Occupants;
+		if (Current)
+		{
+			for (AActor* Combatant : *Current)
+			{
+				if (!Zone.Occupants.Contains(Combatant))
+				{
+					Events.Add({ Zone.Actor, Combatant, true });
+				}
+				Occupants.Add(Combatant);
+			}
+		}
+		Zone.Occupants = MoveTemp(Occupants);
+	}
+
+	for (const FZoneEvent& Event : Events)
+	{
+		AAuraEffectActor* ZoneActor = Event.Zone.Get();
+		AActor* Combatant = Event.Combatant.Get();
+		if (!IsValid(ZoneActor) || !IsValid(Combatant))
+		{
+			continue;
+		}
+		if (Event.bEnter)
+		{
+			ZoneActor->OnOverlap(Combatant);
+		}
+		else
+		{
+			ZoneActor->OnEndOverlap(Combatant);
+		}
+	}
+}
+
+FIntPoint UAuraEffectZoneSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
@@ -0,0 +1,206 @@
+// Giorjorio Copyright
+
+
+#include "Actor/AuraImpactEffectsSubsystem.h"
+
+#include "Aura.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "NiagaraFunctionLibrary.h"
+
+DECLARE_CYCLE_STAT(TEXT("Impact Effects"), STAT_AuraImpactEffects, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Impact Effects Played"), STAT_AuraImpactEffectsPlayed, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Impact Effects Merged"), STAT_AuraImpactEffectsMerged, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Impact Effects Culled"), STAT_AuraImpactEffectsCulled, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Looping Projectile Sounds"), STAT_AuraLoopingProjectileSounds, STATGROUP_Aura);
+
+static int32 GAuraImpactEffectsMaxPerFrame = 16;
+static FAutoConsoleVariableRef CVarAuraImpactEffectsMaxPerFrame(
+	TEXT("Aura.ImpactEffects.MaxPerFrame"),
+	GAuraImpactEffectsMaxPerFrame,
+	TEXT("Impacts played per frame, closest to a local player first. The rest are dropped."));
+
+static float GAuraImpactEffectsMergeRadius = 50.f;
+static FAutoConsoleVariableRef CVarAuraImpactEffectsMergeRadius(
+	TEXT("Aura.ImpactEffects.MergeRadius"),
+	GAuraImpactEffectsMergeRadius,
+	TEXT("Impacts of the same effect closer than this in one frame play once."));
+
+static float GAuraImpactEffectsMaxDistance = 6000.f;
+static FAutoConsoleVariableRef CVarAuraImpactEffectsMaxDistance(
+	TEXT("Aura.ImpactEffects.MaxDistance"),
+	GAuraImpactEffectsMaxDistance,
+	TEXT("Impacts and looping sounds farther than this from every local player are culled."));
+
+static bool GAuraImpactEffectsOcclusion = true;
+static FAutoConsoleVariableRef CVarAuraImpactEffectsOcclusion(
+	TEXT("Aura.ImpactEffects.Occlusion"),
+	GAuraImpactEffectsOcclusion,
+	TEXT("Skip the visual effect of impacts hidden from every local player. The sound still plays."));
+
+static int32 GAuraImpactEffectsMaxLoopingSounds = 24;
+static FAutoConsoleVariableRef CVarAuraImpactEffectsMaxLoopingSounds(
+	TEXT("Aura.ImpactEffects.MaxLoopingSounds"),
+	GAuraImpactEffectsMaxLoopingSounds,
+	TEXT("Projectile looping sounds playing at once."));
+
+void UAuraImpactEffectsSubsystem::PlayImpact(UNiagaraSystem* Effect, USoundBase* Sound, const FVector& Location)
+{
+	if ((!Effect && !Sound) || GetWorld()->GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	const float MergeRadiusSquared = FMath::Square(GAuraImpactEffectsMergeRadius);
+	for (const FAuraImpactEffectRequest& Pending : PendingImpacts)
+	{
+		if (Pending.Effect == Effect && Pending.Sound == Sound && FVector::DistSquared(Pending.Location, Location) < MergeRadiusSquared)
+		{
+			INC_DWORD_STAT(STAT_AuraImpactEffectsMerged);
+			return;
+		}
+	}
+
+	FAuraImpactEffectRequest& Request = PendingImpacts.AddDefaulted_GetRef();
+	Request.Effect = Effect;
+	Request.Sound = Sound;
+	Request.Location = Location;
+}
+
+bool UAuraImpactEffectsSubsystem::AcquireLoopingSound(const FVector& Location)
+{
+	if (GetWorld()->GetNetMode() == NM_DedicatedServer || NumLoopingSounds >= GAuraImpactEffectsMaxLoopingSounds)
+	{
+		return false;
+	}
+
+	UpdateViewLocations();
+	if (GetViewDistanceSquared(Location) > FMath::Square(GAuraImpactEffectsMaxDistance))
+	{
+		return false;
+	}
+
+	++NumLoopingSounds;
+	INC_DWORD_STAT(STAT_AuraLoopingProjectileSounds);
+	return true;
+}
+
+void UAuraImpactEffectsSubsystem::ReleaseLoopingSound()
+{
+	check(NumLoopingSounds > 0);
+	--NumLoopingSounds;
+	DEC_DWORD_STAT(STAT_AuraLoopingProjectileSounds);
+}
+
+void UAuraImpactEffectsSubsystem::Tick(float DeltaTime)
+{
+	if (PendingImpacts.IsEmpty())
+	{
+		return;
+	}
+	SCOPE_CYCLE_COUNTER(STAT_AuraImpactEffects);
+
+	UpdateViewLocations();
+	const float MaxDistanceSquared = FMath::Square(GAuraImpactEffectsMaxDistance);
+	for (FAuraImpactEffectRequest& Request : PendingImpacts)
+	{
+		Request.ViewDistanceSquared = GetViewDistanceSquared(Request.Location);
+	}
+	PendingImpacts.Sort([](const FAuraImpactEffectRequest& A, const FAuraImpactEffectRequest& B)
+	{
+		return A.ViewDistanceSquared < B.ViewDistanceSquared;
+	});
+
+	UWorld* World = GetWorld();
+	const int32 NumToPlay = FMath::Min(PendingImpacts.Num(), GAuraImpactEffectsMaxPerFrame);
+	int32 NumPlayed = 0;
+	for (; NumPlayed < NumToPlay; ++NumPlayed)
+	{
+		const FAuraImpactEffectRequest& Request = PendingImpacts[NumPlayed];
+		if (Request.ViewDistanceSquared > MaxDistanceSquared)
+		{
+			// Sorted, everything after is farther
+			break;
+		}
+
+		if (Request.Sound)
+		{
+			UGameplayStatics::PlaySoundAtLocation(World, Request.Sound, Request.Location, FRotator::ZeroRotator);
+		}
+		if (Request.Effect && !IsOccluded(Request.Location))
+		{
+			UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+				World,
+				Request.Effect,
+				Request.Location,
+				FRotator::ZeroRotator,
+				FVector(1.f),
+				true,
+				true,
+				ENCPoolMethod::AutoRelease);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_AuraImpactEffectsPlayed, NumPlayed);
+	INC_DWORD_STAT_BY(STAT_AuraImpactEffectsCulled, PendingImpacts.Num() - NumPlayed);
+	PendingImpacts.Reset();
+}
+
+TStatId UAuraImpactEffectsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraImpactEffectsSubsystem, STATGROUP_Aura);
+}
+
+bool UAuraImpactEffectsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAuraImpactEffectsSubsystem::UpdateViewLocations()
+{
+	ViewLocations.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+}
+
+float UAuraImpactEffectsSubsystem::GetViewDistanceSquared(const FVector& Location) const
+{
+	// No local player yet: nothing to cull against
+	float DistanceSquared = ViewLocations.IsEmpty() ? 0.f : MAX_flt;
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(ViewLocation, Location));
+	}
+	return DistanceSquared;
+}
+
+bool UAuraImpactEffectsSubsystem::IsOccluded(const FVector& Location) const
+{
+	if (!GAuraImpactEffectsOcclusion || ViewLocations.IsEmpty())
+	{
+		return false;
+	}
+
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AuraImpactOcclusion), false);
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		// Level geometry only, and stop short of the impact, which usually sits on the surface that was hit
+		const FVector End = Location + (ViewLocation - Location).GetSafeNormal() * 50.f;
+		if (!GetWorld()->LineTraceTestByObjectType(ViewLocation, End, FCollisionObjectQueryParams(ECC_WorldStatic), QueryParams))
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -6,11 +6,67 @@
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
 #include "Aura/Aura.h"
+#include "Actor/AuraImpactEffectsSubsystem.h"
+#include "Actor/AuraProjectilePoolSubsystem.h"
+#include "Actor/AuraProjectileSimulationSubsystem.h"
+#include "Character/AuraCharacterBase.h"
+#include "Interaction/CombatInterface.h"
 #include "Components/AudioComponent.h"
 #include "Components/SphereComponent.h"
+#include "GameFramework/GameStateBase.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "NiagaraFunctionLibrary.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/UnrealNetwork.h"
+
+static int32 GAuraProjectileHitMode = -1;
+static FAutoConsoleVariableRef CVarAuraProjectileHitMode(
+	TEXT("Aura.Projectile.HitMode"),
+	GAuraProjectileHitMode,
+	TEXT("-1: per projectile class, 0: overlap events, 1: sweeps. Applies to projectiles launched after the change."));
+
+static bool GAuraProjectileAuditMissedHits = false;
+static FAutoConsoleVariableRef CVarAuraProjectileAuditMissedHits(
+	TEXT("Aura.Projectile.AuditMissedHits"),
+	GAuraProjectileAuditMissedHits,
+	TEXT("Sweep the path of every projectile that expires, counting those that crossed something as missed hits."));
+
+FAuraProjectileHitStats& FAuraProjectileHitStats::Get()
+{
+	static FAuraProjectileHitStats Stats = []
+	{
+		FAuraProjectileHitStats Initial;
+		Initial.StartTime = FPlatformTime::Seconds();
+		return Initial;
+	}();
+	return Stats;
+}
+
+static FAutoConsoleCommandWithArgsAndOutputDevice CAuraProjectileHitStats(
+	TEXT("Aura.Projectile.HitStats"),
+	TEXT("Prints projectile overlap events, sweeps and missed hits per second. 'reset' starts over."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+	{
+		FAuraProjectileHitStats& Stats = FAuraProjectileHitStats::Get();
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			Stats = FAuraProjectileHitStats();
+			Stats.StartTime = FPlatformTime::Seconds();
+			return;
+		}
+
+		const double Seconds = FMath::Max(FPlatformTime::Seconds() - Stats.StartTime, UE_DOUBLE_SMALL_NUMBER);
+		const uint64 Flights = Stats.Hits + Stats.Expired;
+		Ar.Logf(TEXT("Projectile hits over %.1fs: %.1f overlap events/s, %.1f sweeps/s, %llu hits, %llu expired, %llu missed hits (%.2f%% of flights)"),
+			Seconds,
+			Stats.OverlapEvents / Seconds,
+			Stats.Sweeps / Seconds,
+			Stats.Hits,
+			Stats.Expired,
+			Stats.MissedHits,
+			Flights > 0 ? 100.0 * Stats.MissedHits / Flights : 0.0);
+	}));
 
 
 AAuraProjectile::AAuraProjectile()
@@ -26,6 +82,7 @@ AAuraProjectile::AAuraProjectile()
 	Sphere->SetCollisionResponseToChannel(ECC_WorldDynamic,ECR_Overlap);
 	Sphere->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Overlap);
 	Sphere->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+	Sphere->SetCollisionResponseToChannel(ECC_Combat, ECR_Ignore);
 
 	ProjectileMovement = CreateDefaultSubobject<UProjectileMovementComponent>("ProjectileMovement");
 	ProjectileMovement->InitialSpeed = 550.f;
@@ -34,25 +91,49 @@ AAuraProjectile::AAuraProjectile()
 	
 }
 
+void AAuraProjectile::PostInitProperties()
+{
+	// Before Super, which derives the remote role from bReplicates
+	if (bClientSimulated)
+	{
+		bReplicates = false;
+	}
+	Super::PostInitProperties();
+}
+
+void AAuraProjectile::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AAuraProjectile, PoolState);
+}
+
 void AAuraProjectile::BeginPlay()
 {
 	Super::BeginPlay();
-	SetLifeSpan(LifeSpan);
 	Sphere->OnComponentBeginOverlap.AddDynamic(this, &AAuraProjectile::OnSphereOverlap);
+	FlightStartLocation = GetActorLocation();
 
-	LoopingSoundComponent = UGameplayStatics::SpawnSoundAttached(
-		LoopingSound,
-		GetRootComponent(),
-		NAME_None,
-		FVector::Zero(),
-		FRotator::ZeroRotator,
-		EAttachLocation::KeepRelativeOffset,
-		true);
+	if (PoolState.bActive)
+	{
+		SetLifeSpan(LifeSpan);
+		bInFlight = true;
+		StartSimulation();
+		StartLoopingSound();
+	}
+	else
+	{
+		// Pre-warmed, or became relevant while waiting in the pool
+		StopFlight();
+	}
 }
 
 void AAuraProjectile::Destroyed()
 {
-	if (!bHit && !HasAuthority())
+	StopSimulation();
+	StopLoopingSound();
+
+	if (!bHit && !HasAuthority() && bInFlight)
 	{
 		ExecuteImpactEffects();
 	}
@@ -60,13 +141,111 @@ void AAuraProjectile::Destroyed()
 	Super::Destroyed();
 }
 
+void AAuraProjectile::LifeSpanExpired()
+{
+	if (HasAuthority() && !bClientProxy)
+	{
+		++FAuraProjectileHitStats::Get().Expired;
+		AuditExpiredFlight();
+	}
+
+	if (bPooled)
+	{
+		ReturnToPool();
+		return;
+	}
+	Super::LifeSpanExpired();
+}
+
 void AAuraProjectile::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
                                       UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	if (DamageEffectSpecHandle.Data.IsValid() && DamageEffectSpecHandle.Data.Get()->GetContext().GetEffectCauser() == OtherActor)
+	++FAuraProjectileHitStats::Get().OverlapEvents;
+	HandleImpact(OtherActor);
+}
+
+EAuraProjectileHitMode AAuraProjectile::GetHitMode() const
+{
+	// Sweeps are done by the batched simulation
+	if (!UAuraProjectileSimulationSubsystem::IsEnabled())
+	{
+		return EAuraProjectileHitMode::Overlap;
+	}
+	if (GAuraProjectileHitMode >= 0)
+	{
+		return GAuraProjectileHitMode == 0 ? EAuraProjectileHitMode::Overlap : EAuraProjectileHitMode::Sweep;
+	}
+	return HitMode;
+}
+
+void AAuraProjectile::AuditExpiredFlight() const
+{
+	if (!GAuraProjectileAuditMissedHits)
 	{
 		return;
 	}
+
+	// Friendly actors block Combat too but the projectile passes through them, so they are skipped and the sweep goes on
+	constexpr int32 MaxSkippedActors = 8;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AuraProjectileAudit), false, GetDamageCauser());
+	const FCollisionShape Shape = FCollisionShape::MakeSphere(Sphere->GetScaledSphereRadius());
+	for (int32 Sweep = 0; Sweep <= MaxSkippedActors; ++Sweep)
+	{
+		FHitResult Hit;
+		if (!GetWorld()->SweepSingleByChannel(Hit, FlightStartLocation, GetActorLocation(), FQuat::Identity, ECC_Combat, Shape, QueryParams))
+		{
+			return;
+		}
+		AActor* HitActor = Hit.GetActor();
+		if (!HitActor || !ICombatInterface::IsFriendly(GetOwner(), HitActor))
+		{
+			++FAuraProjectileHitStats::Get().MissedHits;
+			return;
+		}
+		QueryParams.AddIgnoredActor(HitActor);
+	}
+}
+
+void AAuraProjectile::SetSharedDamageSpec(const FGameplayEffectSpecHandle& SharedSpecHandle, const FVector& TargetLocation)
+{
+	DamageEffectSpecHandle = SharedSpecHandle;
+
+	SharedDamageContextHandle = FGameplayEffectContextHandle(SharedSpecHandle.Data->GetContext().Duplicate());
+	SharedDamageContextHandle.AddSourceObject(this);
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	Actors.Add(this);
+	SharedDamageContextHandle.AddActors(Actors);
+	FHitResult HitResult;
+	HitResult.Location = TargetLocation;
+	SharedDamageContextHandle.AddHitResult(HitResult);
+}
+
+void AAuraProjectile::ApplySharedDamageSpec(UAbilitySystemComponent* TargetASC) const
+{
+	// The spec is only lent for the application, which copies what it keeps, then gets its own context back
+	FGameplayEffectSpec& SharedSpec = *DamageEffectSpecHandle.Data;
+	const FGameplayEffectContextHandle SpecContextHandle = SharedSpec.GetContext();
+	SharedSpec.SetContext(SharedDamageContextHandle, true);
+	TargetASC->ApplyGameplayEffectSpecToSelf(SharedSpec);
+	SharedSpec.SetContext(SpecContextHandle, true);
+}
+
+AActor* AAuraProjectile::GetDamageCauser() const
+{
+	return DamageEffectSpecHandle.Data.IsValid() ? DamageEffectSpecHandle.Data->GetContext().GetEffectCauser() : nullptr;
+}
+
+bool AAuraProjectile::HandleImpact(AActor* OtherActor)
+{
+	if (DamageEffectSpecHandle.Data.IsValid() && GetDamageCauser() == OtherActor)
+	{
+		return false;
+	}
+	// Owner rather than damage causer, clients have no spec
+	if (ICombatInterface::IsFriendly(GetOwner(), OtherActor))
+	{
+		return false;
+	}
 	if (!bHit)
 	{
 		ExecuteImpactEffects();
@@ -74,23 +253,299 @@ void AAuraProjectile::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent,
 	
 	if (HasAuthority())
 	{
-		if (UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(OtherActor))
+		++FAuraProjectileHitStats::Get().Hits;
+		UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(OtherActor);
+		if (TargetASC && DamageEffectSpecHandle.Data.IsValid())
+		{
+			if (SharedDamageContextHandle.IsValid())
+			{
+				ApplySharedDamageSpec(TargetASC);
+			}
+			else
+			{
+				TargetASC->ApplyGameplayEffectSpecToSelf(*DamageEffectSpecHandle.Data);
+			}
+		}
+
+		if (ProjectileId != 0)
 		{
-			TargetASC->ApplyGameplayEffectSpecToSelf(*DamageEffectSpecHandle.Data);
+			if (AAuraCharacterBase* Caster = Cast<AAuraCharacterBase>(GetOwner()))
+			{
+				Caster->MulticastProjectileImpact(ProjectileId, GetActorLocation());
+			}
 		}
 		
-		Destroy();
+		ReturnToPool();
 	}
 	else
 	{
 		bHit = true;
 	}
+	return true;
 }
 
 void AAuraProjectile::ExecuteImpactEffects() const
 {
+	if (UAuraImpactEffectsSubsystem* ImpactEffects = GetWorld()->GetSubsystem<UAuraImpactEffectsSubsystem>())
+	{
+		ImpactEffects->PlayImpact(ImpactEffect, ImpactSound, GetActorLocation());
+		return;
+	}
 	UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation(), FRotator::ZeroRotator);
 	UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, ImpactEffect, GetActorLocation());
 }
 
+void AAuraProjectile::StartLoopingSound()
+{
+	if (!LoopingSound || bLoopingSoundBudgeted)
+	{
+		return;
+	}
+	UAuraImpactEffectsSubsystem* ImpactEffects = GetWorld()->GetSubsystem<UAuraImpactEffectsSubsystem>();
+	if (ImpactEffects && !ImpactEffects->AcquireLoopingSound(GetActorLocation()))
+	{
+		return;
+	}
+	bLoopingSoundBudgeted = ImpactEffects != nullptr;
+
+	if (LoopingSoundComponent)
+	{
+		LoopingSoundComponent->Play();
+	}
+	else
+	{
+		// Not auto destroyed: StopFlight stops it and the next flight from the pool plays it again
+		LoopingSoundComponent = UGameplayStatics::SpawnSoundAttached(
+			LoopingSound,
+			GetRootComponent(),
+			NAME_None,
+			FVector::Zero(),
+			FRotator::ZeroRotator,
+			EAttachLocation::KeepRelativeOffset,
+			true,
+			1.f,
+			1.f,
+			0.f,
+			nullptr,
+			nullptr,
+			false);
+	}
+}
 
+void AAuraProjectile::StopLoopingSound()
+{
+	if (LoopingSoundComponent)
+	{
+		LoopingSoundComponent->Stop();
+	}
+	if (bLoopingSoundBudgeted)
+	{
+		bLoopingSoundBudgeted = false;
+		if (UAuraImpactEffectsSubsystem* ImpactEffects = GetWorld()->GetSubsystem<UAuraImpactEffectsSubsystem>())
+		{
+			ImpactEffects->ReleaseLoopingSound();
+		}
+	}
+}
+
+void AAuraProjectile::InitDormant()
+{
+	check(HasAuthority() && bPooled && !IsActorInitialized());
+
+	PoolState.bActive = false;
+	SetActorHiddenInGame(true);
+	Sphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	ProjectileMovement->bAutoActivate = false;
+
+	// Clients hear of it on its first launch
+	if (GetIsReplicated())
+	{
+		SetNetDormancy(DORM_Initial);
+	}
+}
+
+void AAuraProjectile::LaunchFromPool(const FTransform& SpawnTransform)
+{
+	check(HasAuthority());
+
+	if (GetIsReplicated())
+	{
+		SetNetDormancy(DORM_Awake);
+	}
+
+	PoolState.bActive = true;
+	++PoolState.LaunchCount;
+	PoolState.LaunchLocation = SpawnTransform.GetLocation();
+	PoolState.LaunchRotation = SpawnTransform.Rotator();
+	PoolState.LaunchTime = GetWorld()->GetTimeSeconds();
+	LocalLaunchCount = PoolState.LaunchCount;
+
+	StartFlight(SpawnTransform);
+	SetLifeSpan(LifeSpan);
+}
+
+void AAuraProjectile::ReturnToPool()
+{
+	UAuraProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UAuraProjectilePoolSubsystem>();
+	if (!bPooled || !ProjectilePool)
+	{
+		Destroy();
+		return;
+	}
+	if (!PoolState.bActive)
+	{
+		return;
+	}
+
+	PoolState.bActive = false;
+	SetLifeSpan(0.f);
+	StopFlight();
+	DamageEffectSpecHandle.Clear();
+	SharedDamageContextHandle.Clear();
+
+	// Replicates the final state, then closes the channel until the next launch
+	if (GetIsReplicated())
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+
+	ProjectilePool->ReleaseProjectile(this);
+	ProjectileId = 0;
+}
+
+void AAuraProjectile::OnRep_PoolState()
+{
+	if (PoolState.LaunchCount != LocalLaunchCount)
+	{
+		// A new flight, possibly already over if the return happened before this update went out
+		LocalLaunchCount = PoolState.LaunchCount;
+		if (PoolState.bActive)
+		{
+			// Late joiners and clients that just got relevancy start where the server projectile is by now
+			const float FlightTime = GetElapsedServerTime(PoolState.LaunchTime);
+			const FVector Direction = PoolState.LaunchRotation.Vector();
+			StartFlight(FTransform(PoolState.LaunchRotation, PoolState.LaunchLocation + Direction * ProjectileMovement->InitialSpeed * FlightTime));
+		}
+		else
+		{
+			StopFlight();
+		}
+	}
+	else if (!PoolState.bActive && bInFlight)
+	{
+		// Stands in for the impact effects clients used to play when the projectile got destroyed
+		if (!bHit)
+		{
+			ExecuteImpactEffects();
+		}
+		StopFlight();
+	}
+}
+
+void AAuraProjectile::StartFlight(const FTransform& SpawnTransform)
+{
+	bHit = false;
+	bInFlight = true;
+	FlightStartLocation = SpawnTransform.GetLocation();
+	SetActorLocationAndRotation(SpawnTransform.GetLocation(), SpawnTransform.GetRotation());
+	SetActorHiddenInGame(false);
+	Sphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+
+	ProjectileMovement->Activate(true);
+	ProjectileMovement->Velocity = SpawnTransform.GetRotation().Vector() * ProjectileMovement->InitialSpeed;
+
+	StartSimulation();
+	StartLoopingSound();
+}
+
+void AAuraProjectile::StopFlight()
+{
+	bInFlight = false;
+	StopSimulation();
+	SetActorHiddenInGame(true);
+	Sphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+
+	StopLoopingSound();
+}
+
+float AAuraProjectile::GetElapsedServerTime(float ServerTime) const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? FMath::Clamp(GameState->GetServerWorldTimeSeconds() - ServerTime, 0.f, LifeSpan) : 0.f;
+}
+
+FAuraProjectileSpawnEvent AAuraProjectile::MakeSpawnEvent() const
+{
+	FAuraProjectileSpawnEvent SpawnEvent;
+	SpawnEvent.ProjectileId = ProjectileId;
+	SpawnEvent.ProjectileClass = GetClass();
+	SpawnEvent.Origin = GetActorLocation();
+	SpawnEvent.Direction = GetActorForwardVector();
+	SpawnEvent.Speed = ProjectileMovement->InitialSpeed;
+	SpawnEvent.SpawnTime = GetWorld()->GetTimeSeconds();
+	return SpawnEvent;
+}
+
+void AAuraProjectile::InitClientProxy(const FAuraProjectileSpawnEvent& SpawnEvent)
+{
+	bClientProxy = true;
+	ProjectileId = SpawnEvent.ProjectileId;
+	ProjectileMovement->InitialSpeed = SpawnEvent.Speed;
+	ProjectileMovement->MaxSpeed = FMath::Max(ProjectileMovement->MaxSpeed, SpawnEvent.Speed);
+}
+
+void AAuraProjectile::HandleServerImpact(const FVector& ImpactLocation)
+{
+	SetActorLocation(ImpactLocation);
+	ExecuteImpactEffects();
+	ReturnToPool();
+}
+
+void AAuraProjectile::StartSimulation()
+{
+	if (bClientProxy)
+	{
+		// The server sends the hits
+		Sphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		return;
+	}
+
+	// Clients of sweeping projectiles play the impact when the flight ends instead
+	const EAuraProjectileHitMode CurrentHitMode = GetHitMode();
+	Sphere->SetGenerateOverlapEvents(CurrentHitMode == EAuraProjectileHitMode::Overlap);
+	if (!HasAuthority() || !UAuraProjectileSimulationSubsystem::IsEnabled())
+	{
+		return;
+	}
+	UAuraProjectileSimulationSubsystem* Simulation = GetWorld()->GetSubsystem<UAuraProjectileSimulationSubsystem>();
+	if (!Simulation)
+	{
+		return;
+	}
+
+	Simulation->AddProjectile(this);
+
+	// Clients keep both for the visuals, they are not told about this. Overlapping projectiles keep their collision,
+	// the simulation moves them with a sweep that fires the overlaps.
+	ProjectileMovement->Deactivate();
+	if (CurrentHitMode == EAuraProjectileHitMode::Sweep)
+	{
+		Sphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	}
+}
+
+void AAuraProjectile::StopSimulation()
+{
+	if (SimulationIndex == INDEX_NONE)
+	{
+		return;
+	}
+	if (UAuraProjectileSimulationSubsystem* Simulation = GetWorld()->GetSubsystem<UAuraProjectileSimulationSubsystem>())
+	{
+		Simulation->RemoveProjectile(this);
+	}
+	SimulationIndex = INDEX_NONE;
+}
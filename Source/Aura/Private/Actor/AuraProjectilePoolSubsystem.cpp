@@ -0,0 +1,156 @@
+// Giorjorio Copyright
+
+
+#include "Actor/AuraProjectilePoolSubsystem.h"
+
+#include "Aura.h"
+#include "Actor/AuraProjectile.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Spawned"), STAT_AuraProjectilesSpawned, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Reused"), STAT_AuraProjectilesReused, STATGROUP_Aura);
+
+static int32 GAuraMaxDormantProjectilesPerClass = 64;
+static FAutoConsoleVariableRef CVarAuraMaxDormantProjectilesPerClass(
+	TEXT("Aura.ProjectilePool.MaxDormantPerClass"),
+	GAuraMaxDormantProjectilesPerClass,
+	TEXT("Dormant projectiles kept per class. Projectiles returned past this are destroyed."));
+
+AAuraProjectile* UAuraProjectilePoolSubsystem::AcquireProjectile(TSubclassOf<AAuraProjectile> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+{
+	check(ProjectileClass);
+
+	if (FAuraProjectilePool* Pool = Pools.Find(ProjectileClass))
+	{
+		while (!Pool->Dormant.IsEmpty())
+		{
+			AAuraProjectile* Projectile = Pool->Dormant.Pop(EAllowShrinking::No);
+			if (IsValid(Projectile))
+			{
+				INC_DWORD_STAT(STAT_AuraProjectilesReused);
+				Projectile->SetOwner(Owner);
+				Projectile->SetInstigator(Instigator);
+				return Projectile;
+			}
+		}
+	}
+
+	return SpawnPooledProjectile(ProjectileClass, SpawnTransform, Owner, Instigator);
+}
+
+void UAuraProjectilePoolSubsystem::LaunchProjectile(AAuraProjectile* Projectile, const FTransform& SpawnTransform)
+{
+	check(Projectile);
+
+	if (Projectile->IsActorInitialized())
+	{
+		Projectile->LaunchFromPool(SpawnTransform);
+	}
+	else
+	{
+		Projectile->FinishSpawning(SpawnTransform);
+	}
+}
+
+void UAuraProjectilePoolSubsystem::ReleaseProjectile(AAuraProjectile* Projectile)
+{
+	if (Projectile->GetProjectileId() != 0)
+	{
+		ClientProjectiles.Remove(Projectile->GetProjectileId());
+	}
+
+	FAuraProjectilePool& Pool = Pools.FindOrAdd(Projectile->GetClass());
+	if (Pool.Dormant.Num() >= GAuraMaxDormantProjectilesPerClass)
+	{
+		Projectile->Destroy();
+		return;
+	}
+	Pool.Dormant.Add(Projectile);
+}
+
+void UAuraProjectilePoolSubsystem::PrewarmProjectiles(TSubclassOf<AAuraProjectile> ProjectileClass, int32 Count)
+{
+	if (!ProjectileClass || GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	const int32 NumDormant = Pools.FindOrAdd(ProjectileClass).Dormant.Num();
+	Count = FMath::Min(Count, GAuraMaxDormantProjectilesPerClass);
+	for (int32 i = NumDormant; i < Count; ++i)
+	{
+		AAuraProjectile* Projectile = SpawnPooledProjectile(ProjectileClass, FTransform::Identity, nullptr, nullptr);
+		Projectile->InitDormant();
+		Projectile->FinishSpawning(FTransform::Identity);
+		ReleaseProjectile(Projectile);
+	}
+}
+
+uint32 UAuraProjectilePoolSubsystem::GenerateProjectileId()
+{
+	// 0 means no id
+	if (++LastProjectileId == 0)
+	{
+		++LastProjectileId;
+	}
+	return LastProjectileId;
+}
+
+void UAuraProjectilePoolSubsystem::SpawnClientProjectile(const FAuraProjectileSpawnEvent& SpawnEvent)
+{
+	if (!SpawnEvent.ProjectileClass || SpawnEvent.ProjectileId == 0)
+	{
+		return;
+	}
+
+	// Start where the server projectile is by now
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const float FlightTime = GameState ? FMath::Max(GameState->GetServerWorldTimeSeconds() - SpawnEvent.SpawnTime, 0.f) : 0.f;
+	const FVector Direction = SpawnEvent.Direction;
+	const FTransform SpawnTransform(Direction.Rotation(), SpawnEvent.Origin + Direction * SpawnEvent.Speed * FlightTime);
+
+	AAuraProjectile* Projectile = AcquireProjectile(SpawnEvent.ProjectileClass, SpawnTransform, nullptr, nullptr);
+	Projectile->InitClientProxy(SpawnEvent);
+	LaunchProjectile(Projectile, SpawnTransform);
+
+	// Expiry is not sent, so the proxy only lives for what is left of the server life span
+	const float RemainingLifeSpan = Projectile->GetLifeSpan() - FlightTime;
+	if (RemainingLifeSpan <= 0.f)
+	{
+		Projectile->ReturnToPool();
+		return;
+	}
+	Projectile->SetLifeSpan(RemainingLifeSpan);
+
+	ClientProjectiles.Add(SpawnEvent.ProjectileId, Projectile);
+}
+
+void UAuraProjectilePoolSubsystem::ImpactClientProjectile(uint32 ProjectileId, const FVector& ImpactLocation)
+{
+	TWeakObjectPtr<AAuraProjectile> Projectile;
+	if (ClientProjectiles.RemoveAndCopyValue(ProjectileId, Projectile) && Projectile.IsValid() && Projectile->GetProjectileId() == ProjectileId)
+	{
+		Projectile->HandleServerImpact(ImpactLocation);
+	}
+}
+
+bool UAuraProjectilePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+AAuraProjectile* UAuraProjectilePoolSubsystem::SpawnPooledProjectile(TSubclassOf<AAuraProjectile> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+{
+	INC_DWORD_STAT(STAT_AuraProjectilesSpawned);
+
+	AAuraProjectile* Projectile = GetWorld()->SpawnActorDeferred<AAuraProjectile>(
+		ProjectileClass,
+		SpawnTransform,
+		Owner,
+		Instigator,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	Projectile->SetPooled();
+	return Projectile;
+}
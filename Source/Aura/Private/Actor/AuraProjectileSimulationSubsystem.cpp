@@ -0,0 +1,180 @@
+// Giorjorio Copyright
+
+
+#include "Actor/AuraProjectileSimulationSubsystem.h"
+
+#include "Aura.h"
+#include "Actor/AuraProjectile.h"
+#include "Async/ParallelFor.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Simulation"), STAT_AuraProjectileSimulation, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Simulated Projectiles"), STAT_AuraSimulatedProjectiles, STATGROUP_Aura);
+
+static bool GAuraBatchedProjectileSimulation = true;
+static FAutoConsoleVariableRef CVarAuraBatchedProjectileSimulation(
+	TEXT("Aura.ProjectileSimulation.Batched"),
+	GAuraBatchedProjectileSimulation,
+	TEXT("Move server projectiles in one batched step, whatever their hit mode. Applies to projectiles launched after the change."));
+
+/** Below this the sweeps run on the game thread, the task overhead is not worth it. */
+static constexpr int32 MinProjectilesForParallelSweeps = 16;
+
+bool UAuraProjectileSimulationSubsystem::IsEnabled()
+{
+	return GAuraBatchedProjectileSimulation;
+}
+
+void UAuraProjectileSimulationSubsystem::AddProjectile(AAuraProjectile* Projectile)
+{
+	check(Projectile);
+	if (Projectile->SimulationIndex != INDEX_NONE)
+	{
+		RemoveProjectile(Projectile);
+	}
+
+	Projectile->SimulationIndex = Projectiles.Add(Projectile);
+	IgnoredActors.AddDefaulted_GetRef().Add(Projectile->GetDamageCauser());
+	Locations.Add(Projectile->GetActorLocation());
+	Velocities.Add(Projectile->ProjectileMovement->Velocity);
+	Radii.Add(Projectile->Sphere->GetScaledSphereRadius());
+	GravityZ.Add(Projectile->ProjectileMovement->GetGravityZ());
+	SweepForHits.Add(Projectile->GetHitMode() == EAuraProjectileHitMode::Sweep);
+}
+
+void UAuraProjectileSimulationSubsystem::RemoveProjectile(AAuraProjectile* Projectile)
+{
+	check(Projectile);
+	const int32 Index = Projectile->SimulationIndex;
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	check(Projectiles[Index] == Projectile);
+	RemoveAtSwap(Index);
+	Projectile->SimulationIndex = INDEX_NONE;
+}
+
+void UAuraProjectileSimulationSubsystem::RemoveAtSwap(int32 Index)
+{
+	Projectiles.RemoveAtSwap(Index, EAllowShrinking::No);
+	IgnoredActors.RemoveAtSwap(Index, EAllowShrinking::No);
+	Locations.RemoveAtSwap(Index, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, EAllowShrinking::No);
+	Radii.RemoveAtSwap(Index, EAllowShrinking::No);
+	GravityZ.RemoveAtSwap(Index, EAllowShrinking::No);
+	SweepForHits.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	if (Projectiles.IsValidIndex(Index))
+	{
+		if (AAuraProjectile* Moved = Projectiles[Index].Get())
+		{
+			Moved->SimulationIndex = Index;
+		}
+	}
+}
+
+void UAuraProjectileSimulationSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AuraProjectileSimulation);
+
+	// Projectiles can go away without unregistering, e.g. with their streaming level
+	for (int32 i = Projectiles.Num() - 1; i >= 0; --i)
+	{
+		if (!Projectiles[i].IsValid())
+		{
+			RemoveAtSwap(i);
+		}
+	}
+
+	const int32 NumProjectiles = Projectiles.Num();
+	SET_DWORD_STAT(STAT_AuraSimulatedProjectiles, NumProjectiles);
+	if (NumProjectiles == 0)
+	{
+		return;
+	}
+
+	// Weak pointers are resolved here, the sweeps only read plain arrays
+	QueryParams.Reset();
+	Hits.SetNum(NumProjectiles, EAllowShrinking::No);
+	int32 NumSweeps = 0;
+	for (int32 i = 0; i < NumProjectiles; ++i)
+	{
+		FCollisionQueryParams& Params = QueryParams.Emplace_GetRef(SCENE_QUERY_STAT(AuraProjectileSweep), false);
+		if (!SweepForHits[i])
+		{
+			continue;
+		}
+		++NumSweeps;
+		for (const TWeakObjectPtr<AActor>& IgnoredActor : IgnoredActors[i])
+		{
+			if (const AActor* Actor = IgnoredActor.Get())
+			{
+				Params.AddIgnoredActor(Actor);
+			}
+		}
+	}
+
+	FAuraProjectileHitStats::Get().Sweeps += NumSweeps;
+
+	const UWorld* World = GetWorld();
+	ParallelFor(NumProjectiles, [this, World, DeltaTime](int32 i)
+	{
+		FVector& Velocity = Velocities[i];
+		Velocity.Z += GravityZ[i] * DeltaTime;
+
+		const FVector Start = Locations[i];
+		const FVector End = Start + Velocity * DeltaTime;
+		FHitResult& Hit = Hits[i];
+		Hit = FHitResult();
+		if (SweepForHits[i])
+		{
+			World->SweepSingleByChannel(Hit, Start, End, FQuat::Identity, ECC_Combat, FCollisionShape::MakeSphere(Radii[i]), QueryParams[i]);
+		}
+		Locations[i] = Hit.bBlockingHit ? Hit.Location : End;
+	}, NumProjectiles < MinProjectilesForParallelSweeps ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	// Moving and impacts can return projectiles to their pool, which reorders the arrays, so both work on copies
+	Moves.Reset();
+	Impacts.Reset();
+	for (int32 i = 0; i < NumProjectiles; ++i)
+	{
+		Moves.Emplace(Projectiles[i], Locations[i]);
+		if (Hits[i].bBlockingHit)
+		{
+			Impacts.Emplace(Projectiles[i], Hits[i].GetActor());
+		}
+	}
+	for (const TPair<TWeakObjectPtr<AAuraProjectile>, FVector>& Move : Moves)
+	{
+		AAuraProjectile* Projectile = Move.Key.Get();
+		if (Projectile && Projectile->SimulationIndex != INDEX_NONE)
+		{
+			// Overlap hit mode: the sphere only overlaps, the sweep never stops but fires the overlaps along the way
+			Projectile->SetActorLocation(Move.Value, !SweepForHits[Projectile->SimulationIndex]);
+		}
+	}
+	for (const TPair<TWeakObjectPtr<AAuraProjectile>, TWeakObjectPtr<AActor>>& Impact : Impacts)
+	{
+		AAuraProjectile* Projectile = Impact.Key.Get();
+		if (Projectile && Projectile->SimulationIndex != INDEX_NONE && !Projectile->HandleImpact(Impact.Value.Get()))
+		{
+			// Passes through, the next sweep starts from the contact
+			IgnoredActors[Projectile->SimulationIndex].Add(Impact.Value);
+		}
+	}
+}
+
+TStatId UAuraProjectileSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraProjectileSimulationSubsystem, STATGROUP_Aura);
+}
+
+bool UAuraProjectileSimulationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
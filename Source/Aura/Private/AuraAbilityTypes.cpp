@@ -1,6 +1,120 @@
 
 #include "AuraAbilityTypes.h"
 
+#include "Aura.h"
+#include "Containers/LockFreeList.h"
+#include "Engine/NetSerialization.h"
+#include "HAL/IConsoleManager.h"
+
+#include <atomic>
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Contexts Live"), STAT_AuraEffectContextsLive, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Contexts Peak"), STAT_AuraEffectContextsPeak, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Context Allocations Avoided"), STAT_AuraEffectContextAllocationsAvoided, STATGROUP_Aura);
+
+/**
+ * Lock-free free list of FAuraGameplayEffectContext sized blocks. Blocks are never returned to the heap.
+ */
+class FAuraEffectContextPool
+{
+public:
+
+	static FAuraEffectContextPool& Get()
+	{
+		// Never destroyed: contexts may still be released during shutdown
+		static FAuraEffectContextPool* Pool = new FAuraEffectContextPool();
+		return *Pool;
+	}
+
+	void* Allocate()
+	{
+		void* Block = FreeBlocks.Pop();
+		if (Block)
+		{
+			++AllocationsAvoided;
+			INC_DWORD_STAT(STAT_AuraEffectContextAllocationsAvoided);
+		}
+		else
+		{
+			Block = FMemory::Malloc(sizeof(FAuraGameplayEffectContext), alignof(FAuraGameplayEffectContext));
+		}
+		++Allocations;
+
+		const int64 NewLive = ++Live;
+		int64 CurrentPeak = Peak.load();
+		while (NewLive > CurrentPeak && !Peak.compare_exchange_weak(CurrentPeak, NewLive))
+		{
+		}
+		INC_DWORD_STAT(STAT_AuraEffectContextsLive);
+		SET_DWORD_STAT(STAT_AuraEffectContextsPeak, Peak.load());
+		return Block;
+	}
+
+	void Free(void* Block)
+	{
+		--Live;
+		DEC_DWORD_STAT(STAT_AuraEffectContextsLive);
+		FreeBlocks.Push(Block);
+	}
+
+	FAuraEffectContextPoolStats GetStats() const
+	{
+		FAuraEffectContextPoolStats Stats;
+		Stats.Live = Live.load();
+		Stats.Peak = Peak.load();
+		Stats.Allocations = Allocations.load();
+		Stats.AllocationsAvoided = AllocationsAvoided.load();
+		return Stats;
+	}
+
+private:
+
+	FLockFreePointerListUnordered<void, PLATFORM_CACHE_LINE_SIZE> FreeBlocks;
+
+	std::atomic<int64> Live = 0;
+	std::atomic<int64> Peak = 0;
+	std::atomic<int64> Allocations = 0;
+	std::atomic<int64> AllocationsAvoided = 0;
+};
+
+void* FAuraGameplayEffectContext::operator new(size_t Size)
+{
+	if (Size != sizeof(FAuraGameplayEffectContext))
+	{
+		return FMemory::Malloc(Size);
+	}
+	return FAuraEffectContextPool::Get().Allocate();
+}
+
+void FAuraGameplayEffectContext::operator delete(void* Ptr, size_t Size)
+{
+	if (!Ptr)
+	{
+		return;
+	}
+	if (Size != sizeof(FAuraGameplayEffectContext))
+	{
+		FMemory::Free(Ptr);
+		return;
+	}
+	FAuraEffectContextPool::Get().Free(Ptr);
+}
+
+FAuraEffectContextPoolStats FAuraGameplayEffectContext::GetPoolStats()
+{
+	return FAuraEffectContextPool::Get().GetStats();
+}
+
+static FAutoConsoleCommandWithOutputDevice CmdAuraEffectContextPoolStats(
+	TEXT("Aura.EffectContextPool.Stats"),
+	TEXT("Prints the live, peak and total FAuraGameplayEffectContext allocations, and how many the pool served without the heap."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		const FAuraEffectContextPoolStats Stats = FAuraGameplayEffectContext::GetPoolStats();
+		Ar.Logf(TEXT("Effect contexts: %lld live, %lld peak, %lld allocations, %lld served from the pool"),
+			Stats.Live, Stats.Peak, Stats.Allocations, Stats.AllocationsAvoided);
+	}));
+
 bool FAuraGameplayEffectContext::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
 	uint32 RepBits = 0;
@@ -29,7 +143,7 @@ bool FAuraGameplayEffectContext::NetSerialize(FArchive& Ar, class UPackageMap* M
 		}
 		if (HitResult.IsValid())
 		{
-			RepBits |= 1 << 5;
+			RepBits |= bUseCompactHitResult ? 1 << 9 : 1 << 5;
 		}
 		if (bHasWorldOrigin)
 		{
@@ -43,8 +157,12 @@ bool FAuraGameplayEffectContext::NetSerialize(FArchive& Ar, class UPackageMap* M
 		{
 			RepBits |= 1 << 8;
 		}
+		if (DamageRollIndex != 0)
+		{
+			RepBits |= 1 << 10;
+		}
 	}
-	Ar.SerializeBits(&RepBits, 9);
+	Ar.SerializeBits(&RepBits, 11);
 
 	if (RepBits & (1 << 0))
 	{
@@ -77,6 +195,19 @@ bool FAuraGameplayEffectContext::NetSerialize(FArchive& Ar, class UPackageMap* M
 		}
 		HitResult->NetSerialize(Ar, Map, bOutSuccess);
 	}
+	bool bCompactHitResultSuccess = true;
+	if (RepBits & (1 << 9))
+	{
+		if (Ar.IsLoading())
+		{
+			HitResult = TSharedPtr<FHitResult>(new FHitResult());
+		}
+		bCompactHitResultSuccess = NetSerializeCompactHitResult(Ar);
+	}
+	if (Ar.IsLoading())
+	{
+		bUseCompactHitResult = (RepBits & (1 << 9)) != 0;
+	}
 	if (RepBits & (1 << 6))
 	{
 		Ar << WorldOrigin;
@@ -94,12 +225,54 @@ bool FAuraGameplayEffectContext::NetSerialize(FArchive& Ar, class UPackageMap* M
 	{
 		Ar << bIsCriticalHit;
 	}
+	if (RepBits & (1 << 10))
+	{
+		Ar.SerializeIntPacked(DamageRollIndex);
+	}
+	else if (Ar.IsLoading())
+	{
+		DamageRollIndex = 0;
+	}
 
 	if (Ar.IsLoading())
 	{
 		AddInstigator(Instigator.Get(), EffectCauser.Get()); // Just to initialize InstigatorAbilitySystemComponent
 	}	
 	
-	bOutSuccess = true;
+	bOutSuccess = bCompactHitResultSuccess;
 	return true;
 }
+
+bool FAuraGameplayEffectContext::NetSerializeCompactHitResult(FArchive& Ar)
+{
+	uint8 bHasNormal = 0;
+	uint8 bHasActor = 0;
+	UObject* HitActor = nullptr;
+	if (Ar.IsSaving())
+	{
+		HitActor = HitResult->GetActor();
+		bHasNormal = !HitResult->Normal.IsNearlyZero();
+		bHasActor = HitActor != nullptr;
+	}
+	Ar.SerializeBits(&bHasNormal, 1);
+	Ar.SerializeBits(&bHasActor, 1);
+
+	bool bSuccess = SerializePackedVector<10, 24>(HitResult->Location, Ar);
+	if (bHasNormal)
+	{
+		bSuccess &= SerializeFixedVector<1, 16>(HitResult->Normal, Ar);
+	}
+	if (bHasActor)
+	{
+		// A net GUID through the package map
+		Ar << HitActor;
+	}
+
+	if (Ar.IsLoading())
+	{
+		HitResult->ImpactPoint = HitResult->Location;
+		HitResult->ImpactNormal = HitResult->Normal;
+		HitResult->HitObjectHandle = FActorInstanceHandle(Cast<AActor>(HitActor));
+	}
+	return bSuccess;
+}
@@ -3,6 +3,7 @@
 
 #include "AuraAssetManager.h"
 #include "AuraGameplayTags.h"
+#include "AbilitySystem/ExecCalc/ExecCalc_Damage.h"
 
 UAuraAssetManager& UAuraAssetManager::Get()
 {
@@ -16,5 +17,6 @@ void UAuraAssetManager::StartInitialLoading()
 	Super::StartInitialLoading();
 
 	FAuraGameplayTags::InitializeNativeGameplayTags();
+	UExecCalc_Damage::InitializeDamageTypeTable();
 	
 }
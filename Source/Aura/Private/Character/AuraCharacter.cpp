@@ -20,6 +20,8 @@ AAuraCharacter::AAuraCharacter()
 	bUseControllerRotationPitch = false;
 	bUseControllerRotationRoll = false;
 	bUseControllerRotationYaw = false;
+
+	Team = static_cast<uint8>(EAuraTeam::Players);
 }
 
 void AAuraCharacter::PossessedBy(AController* NewController)
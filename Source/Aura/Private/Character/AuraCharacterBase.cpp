@@ -5,6 +5,7 @@
 
 #include "AbilitySystemComponent.h"
 #include "AbilitySystem/AuraAbilitySystemComponent.h"
+#include "Actor/AuraProjectilePoolSubsystem.h"
 #include "Aura/Aura.h"
 #include "Components/CapsuleComponent.h"
 
@@ -13,9 +14,11 @@ AAuraCharacterBase::AAuraCharacterBase()
 	PrimaryActorTick.bCanEverTick = false;
 
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore);
+	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Combat, ECR_Ignore);
 	GetCapsuleComponent()->SetGenerateOverlapEvents(false);
 	GetMesh()->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore);
 	GetMesh()->SetCollisionResponseToChannel(ECC_Projectile, ECR_Overlap);
+	GetMesh()->SetCollisionResponseToChannel(ECC_Combat, ECR_Block);
 	GetMesh()->SetGenerateOverlapEvents(true);
 	
 	Weapon = CreateDefaultSubobject<USkeletalMeshComponent>("Weapon");
@@ -56,6 +59,27 @@ void AAuraCharacterBase::MulticastHandleDeath_Implementation()
 	bDead =	true;
 }
 
+void AAuraCharacterBase::MulticastSpawnProjectile_Implementation(const FAuraProjectileSpawnEvent& SpawnEvent)
+{
+	// The server has the projectile itself
+	if (HasAuthority()) return;
+
+	if (UAuraProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UAuraProjectilePoolSubsystem>())
+	{
+		ProjectilePool->SpawnClientProjectile(SpawnEvent);
+	}
+}
+
+void AAuraCharacterBase::MulticastProjectileImpact_Implementation(uint32 ProjectileId, FVector_NetQuantize ImpactLocation)
+{
+	if (HasAuthority()) return;
+
+	if (UAuraProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UAuraProjectilePoolSubsystem>())
+	{
+		ProjectilePool->ImpactClientProjectile(ProjectileId, ImpactLocation);
+	}
+}
+
 void AAuraCharacterBase::BeginPlay()
 {
 	Super::BeginPlay();
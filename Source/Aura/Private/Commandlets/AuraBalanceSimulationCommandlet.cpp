@@ -0,0 +1,395 @@
+// Giorjorio Copyright
+
+
+#include "Commandlets/AuraBalanceSimulationCommandlet.h"
+
+#include "AbilitySystemComponent.h"
+#include "GameplayTagContainer.h"
+#include "AbilitySystem/AuraAbilitySystemLibrary.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/Data/CharacterClassInfo.h"
+#include "AbilitySystem/ExecCalc/AuraDamageKernel.h"
+#include "AbilitySystem/ExecCalc/AuraDamageRandom.h"
+#include "AbilitySystem/ExecCalc/ExecCalc_Damage.h"
+#include "AuraCommandletUtils.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Commandlets/AuraBenchmarkCombatant.h"
+#include "Dom/JsonObject.h"
+#include "Engine/CurveTable.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/StrongObjectPtr.h"
+
+namespace AuraBalanceSimulation
+{
+	static constexpr int32 NumDpsBins = 64;
+
+	struct FSettings
+	{
+		int32 Duels = 100000;
+		int32 MinLevel = 1;
+		int32 MaxLevel = 40;
+		float AttackInterval = 1.f;
+		int32 MaxHits = 1000;
+		int32 Seed = 0;
+	};
+
+	/** Everything the damage formula needs from one class at one level. */
+	struct FCombatantStats
+	{
+		FAuraDamageSourceValues Source;
+		FAuraDamageTargetValues Target;
+		float MaxHealth = 0.f;
+	};
+
+	/**
+	 * One attacker hitting one defender. A hit can only be plain, blocked, critical or both,
+	 * so the formula runs once per outcome and the duels only roll and look up.
+	 */
+	struct FAttack
+	{
+		float Damage[2][2] = {}; // [bBlocked][bCritical]
+		float BlockChance = 0.f;
+		float CriticalHitChance = 0.f;
+
+		FAttack(const FCombatantStats& Attacker, const FCombatantStats& Defender)
+		{
+			for (int32 Blocked = 0; Blocked < 2; ++Blocked)
+			{
+				for (int32 Critical = 0; Critical < 2; ++Critical)
+				{
+					Damage[Blocked][Critical] = AuraDamageKernel::CalculateDamage(Attacker.Source, Defender.Target, Blocked != 0, Critical != 0);
+				}
+			}
+			BlockChance = Defender.Target.BlockChance;
+			CriticalHitChance = AuraDamageKernel::CalculateEffectiveCriticalHitChance(Attacker.Source, Defender.Target);
+		}
+
+		float Roll(uint64 Key) const
+		{
+			const bool bBlocked = AuraDamageRandom::RollPercent(Key, AuraDamageRandom::EStream::Block) <= BlockChance;
+			const bool bCritical = AuraDamageRandom::RollPercent(Key, AuraDamageRandom::EStream::Critical) <= CriticalHitChance;
+			return Damage[bBlocked][bCritical];
+		}
+
+		float GetMaxDamage() const
+		{
+			return FMath::Max(FMath::Max(Damage[0][0], Damage[0][1]), FMath::Max(Damage[1][0], Damage[1][1]));
+		}
+	};
+
+	/** Results of every duel of one matchup at one level, seen from the attacker (side A). */
+	struct FMatchupResult
+	{
+		int32 AttackerClass = 0;
+		int32 DefenderClass = 0;
+		int32 Level = 0;
+
+		int64 AttackerWins = 0;
+		int64 DefenderWins = 0;
+		int64 Draws = 0;
+		int64 Timeouts = 0;
+
+		// Attacker's hits to kill, indexed by hit count, for the duels the attacker won or drew
+		TArray<int64> HitsToKillHistogram;
+
+		double DpsSum = 0.0;
+		double DpsSquaredSum = 0.0;
+		float DpsBinWidth = 0.f;
+		TArray<int64> DpsHistogram;
+	};
+
+	void SimulateMatchup(const FSettings& Settings, const FCombatantStats& Attacker, const FCombatantStats& Defender, uint64 MatchupKey, FMatchupResult& Result)
+	{
+		const FAttack AttackerHit(Attacker, Defender);
+		const FAttack DefenderHit(Defender, Attacker);
+
+		Result.HitsToKillHistogram.SetNumZeroed(Settings.MaxHits + 1);
+		Result.DpsHistogram.SetNumZeroed(NumDpsBins);
+		Result.DpsBinWidth = FMath::Max(AttackerHit.GetMaxDamage() / Settings.AttackInterval, UE_SMALL_NUMBER) / NumDpsBins;
+
+		for (int32 Duel = 0; Duel < Settings.Duels; ++Duel)
+		{
+			const uint64 DuelKey = AuraDamageRandom::Mix(MatchupKey ^ uint64(Duel));
+
+			float AttackerHealth = Attacker.MaxHealth;
+			float DefenderHealth = Defender.MaxHealth;
+			float AttackerDamageDealt = 0.f;
+			int32 Hits = 0;
+
+			// Both sides attack on the same beat
+			while (Hits < Settings.MaxHits && AttackerHealth > 0.f && DefenderHealth > 0.f)
+			{
+				const uint64 HitKey = AuraDamageRandom::Mix(DuelKey + uint64(Hits));
+				const float AttackerDamage = AttackerHit.Roll(HitKey);
+				const float DefenderDamage = DefenderHit.Roll(~HitKey);
+
+				DefenderHealth -= AttackerDamage;
+				AttackerHealth -= DefenderDamage;
+				AttackerDamageDealt += AttackerDamage;
+				++Hits;
+			}
+
+			const bool bAttackerDead = AttackerHealth <= 0.f;
+			const bool bDefenderDead = DefenderHealth <= 0.f;
+			if (bDefenderDead)
+			{
+				if (bAttackerDead)
+				{
+					++Result.Draws;
+				}
+				else
+				{
+					++Result.AttackerWins;
+				}
+				++Result.HitsToKillHistogram[Hits];
+			}
+			else if (bAttackerDead)
+			{
+				++Result.DefenderWins;
+			}
+			else
+			{
+				++Result.Timeouts;
+			}
+
+			const double Dps = Hits > 0 ? AttackerDamageDealt / (Hits * Settings.AttackInterval) : 0.0;
+			Result.DpsSum += Dps;
+			Result.DpsSquaredSum += Dps * Dps;
+			++Result.DpsHistogram[FMath::Clamp(FMath::FloorToInt32(Dps / Result.DpsBinWidth), 0, NumDpsBins - 1)];
+		}
+	}
+
+	/** Value below which Fraction of the histogram's samples fall, in bins. */
+	int32 HistogramPercentile(const TArray<int64>& Histogram, double Fraction)
+	{
+		int64 Total = 0;
+		for (const int64 Count : Histogram) Total += Count;
+		if (Total == 0) return INDEX_NONE;
+
+		const int64 Threshold = FMath::Max<int64>(1, FMath::CeilToInt64(Total * Fraction));
+		int64 Running = 0;
+		for (int32 Bin = 0; Bin < Histogram.Num(); ++Bin)
+		{
+			Running += Histogram[Bin];
+			if (Running >= Threshold) return Bin;
+		}
+		return Histogram.Num() - 1;
+	}
+
+	TArray<TSharedPtr<FJsonValue>> HistogramToJson(const TArray<int64>& Histogram, int32 FirstBin, int32 LastBin)
+	{
+		TArray<TSharedPtr<FJsonValue>> Values;
+		for (int32 Bin = FirstBin; Bin <= LastBin; ++Bin)
+		{
+			Values.Add(MakeShared<FJsonValueNumber>(Histogram[Bin]));
+		}
+		return Values;
+	}
+
+	TSharedRef<FJsonObject> MatchupToJson(const FSettings& Settings, const FMatchupResult& Result)
+	{
+		const UEnum* CharacterClassEnum = StaticEnum<ECharacterClass>();
+		const double NumDuels = double(Settings.Duels);
+
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("attacker"), CharacterClassEnum->GetNameStringByIndex(Result.AttackerClass));
+		Object->SetStringField(TEXT("defender"), CharacterClassEnum->GetNameStringByIndex(Result.DefenderClass));
+		Object->SetNumberField(TEXT("level"), Result.Level);
+		Object->SetNumberField(TEXT("attacker_win_rate"), Result.AttackerWins / NumDuels);
+		Object->SetNumberField(TEXT("defender_win_rate"), Result.DefenderWins / NumDuels);
+		Object->SetNumberField(TEXT("draw_rate"), Result.Draws / NumDuels);
+		Object->SetNumberField(TEXT("timeout_rate"), Result.Timeouts / NumDuels);
+
+		// Time to kill, in seconds, over the duels the attacker killed the defender
+		TSharedRef<FJsonObject> TimeToKill = MakeShared<FJsonObject>();
+		int64 Kills = 0;
+		double HitsSum = 0.0;
+		int32 FirstBin = INDEX_NONE;
+		int32 LastBin = INDEX_NONE;
+		for (int32 Bin = 0; Bin < Result.HitsToKillHistogram.Num(); ++Bin)
+		{
+			const int64 Count = Result.HitsToKillHistogram[Bin];
+			if (Count == 0) continue;
+			Kills += Count;
+			HitsSum += double(Bin) * Count;
+			FirstBin = FirstBin == INDEX_NONE ? Bin : FirstBin;
+			LastBin = Bin;
+		}
+		TimeToKill->SetNumberField(TEXT("kills"), Kills);
+		if (Kills > 0)
+		{
+			TimeToKill->SetNumberField(TEXT("mean"), HitsSum / Kills * Settings.AttackInterval);
+			TimeToKill->SetNumberField(TEXT("p10"), HistogramPercentile(Result.HitsToKillHistogram, 0.10) * Settings.AttackInterval);
+			TimeToKill->SetNumberField(TEXT("p50"), HistogramPercentile(Result.HitsToKillHistogram, 0.50) * Settings.AttackInterval);
+			TimeToKill->SetNumberField(TEXT("p90"), HistogramPercentile(Result.HitsToKillHistogram, 0.90) * Settings.AttackInterval);
+			TimeToKill->SetNumberField(TEXT("p99"), HistogramPercentile(Result.HitsToKillHistogram, 0.99) * Settings.AttackInterval);
+			TimeToKill->SetNumberField(TEXT("histogram_first_hit"), FirstBin);
+			TimeToKill->SetArrayField(TEXT("histogram"), HistogramToJson(Result.HitsToKillHistogram, FirstBin, LastBin));
+		}
+		Object->SetObjectField(TEXT("time_to_kill"), TimeToKill);
+
+		// Attacker DPS over every duel
+		TSharedRef<FJsonObject> Dps = MakeShared<FJsonObject>();
+		const double DpsMean = Result.DpsSum / NumDuels;
+		Dps->SetNumberField(TEXT("mean"), DpsMean);
+		Dps->SetNumberField(TEXT("stddev"), FMath::Sqrt(FMath::Max(0.0, Result.DpsSquaredSum / NumDuels - DpsMean * DpsMean)));
+		Dps->SetNumberField(TEXT("p10"), (HistogramPercentile(Result.DpsHistogram, 0.10) + 0.5) * Result.DpsBinWidth);
+		Dps->SetNumberField(TEXT("p50"), (HistogramPercentile(Result.DpsHistogram, 0.50) + 0.5) * Result.DpsBinWidth);
+		Dps->SetNumberField(TEXT("p90"), (HistogramPercentile(Result.DpsHistogram, 0.90) + 0.5) * Result.DpsBinWidth);
+		Dps->SetNumberField(TEXT("histogram_bin_width"), Result.DpsBinWidth);
+		Dps->SetArrayField(TEXT("histogram"), HistogramToJson(Result.DpsHistogram, 0, NumDpsBins - 1));
+		Object->SetObjectField(TEXT("dps"), Dps);
+		return Object;
+	}
+}
+
+UAuraBalanceSimulationCommandlet::UAuraBalanceSimulationCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UAuraBalanceSimulationCommandlet::Main(const FString& Params)
+{
+	using namespace AuraBalanceSimulation;
+	using namespace AuraCommandletUtils;
+
+	FSettings Settings;
+	FParse::Value(*Params, TEXT("Duels="), Settings.Duels);
+	FParse::Value(*Params, TEXT("MinLevel="), Settings.MinLevel);
+	FParse::Value(*Params, TEXT("MaxLevel="), Settings.MaxLevel);
+	FParse::Value(*Params, TEXT("AttackInterval="), Settings.AttackInterval);
+	FParse::Value(*Params, TEXT("MaxHits="), Settings.MaxHits);
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	Settings.Duels = FMath::Max(Settings.Duels, 1);
+	Settings.MinLevel = FMath::Max(Settings.MinLevel, 1);
+	Settings.MaxLevel = FMath::Max(Settings.MaxLevel, Settings.MinLevel);
+	Settings.AttackInterval = FMath::Max(Settings.AttackInterval, UE_KINDA_SMALL_NUMBER);
+	Settings.MaxHits = FMath::Max(Settings.MaxHits, 1);
+
+	FString AbilityRow = TEXT("Abilities.Firebolt");
+	FParse::Value(*Params, TEXT("Ability="), AbilityRow);
+	FString DamageTypeName = TEXT("Damage.Fire");
+	FParse::Value(*Params, TEXT("DamageType="), DamageTypeName);
+
+	FString ClassInfoPath = TEXT("/Game/Blueprints/AbilitySystem/Data/DA_CharacterClassInfo.DA_CharacterClassInfo");
+	FParse::Value(*Params, TEXT("ClassInfo="), ClassInfoPath);
+
+	FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Balance"), FString::Printf(TEXT("AuraBalanceSimulation-%s.json"), *FDateTime::Now().ToString()));
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	UExecCalc_Damage::InitializeDamageTypeTable();
+	const int32 DamageTypeIndex = UExecCalc_Damage::FindDamageTypeIndex(FGameplayTag::RequestGameplayTag(FName(*DamageTypeName), false));
+	if (DamageTypeIndex == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Error, TEXT("AuraBalanceSimulation: %s is not a damage type"), *DamageTypeName);
+		return 1;
+	}
+
+	UCharacterClassInfo* CharacterClassInfo = LoadObject<UCharacterClassInfo>(nullptr, *ClassInfoPath);
+	if (CharacterClassInfo == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("AuraBalanceSimulation: could not load Character Class Info %s"), *ClassInfoPath);
+		return 1;
+	}
+
+	FWorld World;
+	if (!World.Initialize(CharacterClassInfo, TEXT("AuraBalanceSimulation"))) return 1;
+
+	/*
+	 * Combatants: the same Gameplay Effects as in game (InitializeDefaultAttributes), with the primary attributes overridden
+	 * by the designer-edited curves in <Project>/Data. Attribute-based secondaries and MMCs pick the override up.
+	 */
+	const double SetupStartTime = FPlatformTime::Seconds();
+	const TStrongObjectPtr<UCurveTable> DamageCurves(LoadCurveTable(TEXT("CT_Damage"), TEXT("AuraBalanceSimulation")));
+	const UEnum* CharacterClassEnum = StaticEnum<ECharacterClass>();
+	const int32 NumClasses = CharacterClassEnum->NumEnums() - 1;
+	const int32 NumLevels = Settings.MaxLevel - Settings.MinLevel + 1;
+
+	TArray<FCombatantStats> Stats; // [Class][Level]
+	Stats.SetNum(NumClasses * NumLevels);
+	for (int32 ClassIndex = 0; ClassIndex < NumClasses; ++ClassIndex)
+	{
+		const ECharacterClass CharacterClass = static_cast<ECharacterClass>(CharacterClassEnum->GetValueByIndex(ClassIndex));
+		const TStrongObjectPtr<UCurveTable> PrimaryAttributeCurves(LoadCurveTable(TEXT("CT_PrimaryAttributes_") + CharacterClassEnum->GetNameStringByIndex(ClassIndex), TEXT("AuraBalanceSimulation")));
+
+		for (int32 LevelIndex = 0; LevelIndex < NumLevels; ++LevelIndex)
+		{
+			const int32 Level = Settings.MinLevel + LevelIndex;
+			AAuraBenchmarkCombatant* Combatant = World.SpawnCombatant(Level);
+			UAbilitySystemComponent* ASC = Combatant->GetAbilitySystemComponent();
+			UAuraAbilitySystemLibrary::InitializeDefaultAttributes(World.World, CharacterClass, Level, ASC);
+			SetPrimaryAttributesFromCurves(ASC, PrimaryAttributeCurves.Get(), Level);
+
+			FCombatantStats& CombatantStats = Stats[ClassIndex * NumLevels + LevelIndex];
+			UExecCalc_Damage::ReadSourceValues(ASC, Level, CharacterClassInfo, CombatantStats.Source);
+			UExecCalc_Damage::ReadTargetValues(ASC, Level, CharacterClassInfo, CombatantStats.Target);
+			CombatantStats.Source.DamageByType[DamageTypeIndex] = EvalCurve(DamageCurves.Get(), FName(*AbilityRow), Level);
+			CombatantStats.MaxHealth = ASC->GetNumericAttribute(UAuraAttributeSet::GetMaxHealthAttribute());
+
+			Combatant->Destroy();
+		}
+	}
+	const double SetupSeconds = FPlatformTime::Seconds() - SetupStartTime;
+
+	/* Duels: one task per (attacker, defender, level), spread over every core */
+	TArray<FMatchupResult> Results;
+	Results.SetNum(NumClasses * NumClasses * NumLevels);
+	const double SimulationStartTime = FPlatformTime::Seconds();
+	ParallelFor(Results.Num(), [&](int32 ResultIndex)
+	{
+		const int32 LevelIndex = ResultIndex % NumLevels;
+		const int32 DefenderClass = (ResultIndex / NumLevels) % NumClasses;
+		const int32 AttackerClass = ResultIndex / (NumLevels * NumClasses);
+
+		FMatchupResult& Result = Results[ResultIndex];
+		Result.AttackerClass = AttackerClass;
+		Result.DefenderClass = DefenderClass;
+		Result.Level = Settings.MinLevel + LevelIndex;
+
+		const uint64 MatchupKey = AuraDamageRandom::Mix((uint64(uint32(Settings.Seed)) << 32) | uint32(ResultIndex));
+		SimulateMatchup(Settings, Stats[AttackerClass * NumLevels + LevelIndex], Stats[DefenderClass * NumLevels + LevelIndex], MatchupKey, Result);
+	});
+	const double SimulationSeconds = FPlatformTime::Seconds() - SimulationStartTime;
+
+	const int64 TotalDuels = int64(Results.Num()) * Settings.Duels;
+	UE_LOG(LogTemp, Display, TEXT("AuraBalanceSimulation: %lld duels in %.2f s (%.0f duels/s, %d worker threads), setup %.2f s"),
+		TotalDuels, SimulationSeconds, TotalDuels / FMath::Max(SimulationSeconds, UE_DOUBLE_SMALL_NUMBER), FTaskGraphInterface::Get().GetNumWorkerThreads(), SetupSeconds);
+
+	/* Report */
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("simulation"), TEXT("AuraBalanceSimulation"));
+	Root->SetNumberField(TEXT("format_version"), 1);
+	Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	Root->SetStringField(TEXT("ability"), AbilityRow);
+	Root->SetStringField(TEXT("damage_type"), DamageTypeName);
+	Root->SetNumberField(TEXT("duels_per_matchup"), Settings.Duels);
+	Root->SetNumberField(TEXT("attack_interval"), Settings.AttackInterval);
+	Root->SetNumberField(TEXT("max_hits"), Settings.MaxHits);
+	Root->SetNumberField(TEXT("seed"), Settings.Seed);
+	Root->SetNumberField(TEXT("simulation_seconds"), SimulationSeconds);
+
+	TArray<TSharedPtr<FJsonValue>> MatchupValues;
+	for (const FMatchupResult& Result : Results)
+	{
+		MatchupValues.Add(MakeShared<FJsonValueObject>(MatchupToJson(Settings, Result)));
+	}
+	Root->SetArrayField(TEXT("matchups"), MatchupValues);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, JsonWriter);
+	if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("AuraBalanceSimulation: could not write %s"), *OutputPath);
+		return 1;
+	}
+	UE_LOG(LogTemp, Display, TEXT("AuraBalanceSimulation: results written to %s"), *OutputPath);
+	return 0;
+}
@@ -0,0 +1,32 @@
+// Giorjorio Copyright
+
+
+#include "Commandlets/AuraBenchmarkCombatant.h"
+
+#include "AbilitySystem/AuraAbilitySystemComponent.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+
+AAuraBenchmarkCombatant::AAuraBenchmarkCombatant()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	AbilitySystemComponent = CreateDefaultSubobject<UAuraAbilitySystemComponent>("AbilitySystemComponent");
+	AttributeSet = CreateDefaultSubobject<UAuraAttributeSet>("AttributeSet");
+}
+
+UAbilitySystemComponent* AAuraBenchmarkCombatant::GetAbilitySystemComponent() const
+{
+	return AbilitySystemComponent;
+}
+
+int32 AAuraBenchmarkCombatant::GetPlayerLevel()
+{
+	return Level;
+}
+
+void AAuraBenchmarkCombatant::InitAbilityActorInfo()
+{
+	AbilitySystemComponent->InitAbilityActorInfo(this, this);
+	AbilitySystemComponent->AddSpawnedAttribute(AttributeSet);
+	Cast<UAuraAbilitySystemComponent>(AbilitySystemComponent)->AbilityActorInfoSet();
+}
@@ -0,0 +1,92 @@
+// Giorjorio Copyright
+
+
+#include "AuraCommandletUtils.h"
+
+#include "AbilitySystemComponent.h"
+#include "AuraGameplayTags.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "Commandlets/AuraBenchmarkCombatant.h"
+#include "Engine/CurveTable.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Game/AuraGameModeBase.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UCurveTable* AuraCommandletUtils::LoadCurveTable(const FString& BaseName, const TCHAR* Caller)
+{
+	const FString DataDir = FPaths::Combine(FPaths::ProjectDir(), TEXT("Data"));
+	const FString CSVPath = FPaths::Combine(DataDir, BaseName + TEXT(".csv"));
+	const FString JSONPath = FPaths::Combine(DataDir, BaseName + TEXT(".json"));
+	const bool bCSV = FPaths::FileExists(CSVPath);
+
+	FString Contents;
+	if (!FFileHelper::LoadFileToString(Contents, bCSV ? *CSVPath : *JSONPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: could not read %s"), Caller, bCSV ? *CSVPath : *JSONPath);
+		return nullptr;
+	}
+
+	UCurveTable* CurveTable = NewObject<UCurveTable>(GetTransientPackage(), FName(*BaseName));
+	const TArray<FString> Problems = bCSV ? CurveTable->CreateTableFromCSVString(Contents) : CurveTable->CreateTableFromJSONString(Contents);
+	for (const FString& Problem : Problems)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: %s: %s"), Caller, *BaseName, *Problem);
+	}
+	return CurveTable;
+}
+
+float AuraCommandletUtils::EvalCurve(const UCurveTable* CurveTable, FName RowName, float Level)
+{
+	const FRealCurve* Curve = CurveTable ? CurveTable->FindCurve(RowName, TEXT("AuraCommandletUtils")) : nullptr;
+	return Curve ? Curve->Eval(Level) : 0.f;
+}
+
+void AuraCommandletUtils::SetPrimaryAttributesFromCurves(UAbilitySystemComponent* ASC, const UCurveTable* PrimaryAttributes, float Level)
+{
+	const FAuraGameplayTags& Tags = FAuraGameplayTags::Get();
+	ASC->SetNumericAttributeBase(UAuraAttributeSet::GetStrengthAttribute(), EvalCurve(PrimaryAttributes, Tags.Attributes_Primary_Strength.GetTagName(), Level));
+	ASC->SetNumericAttributeBase(UAuraAttributeSet::GetIntelligenceAttribute(), EvalCurve(PrimaryAttributes, Tags.Attributes_Primary_Intelligence.GetTagName(), Level));
+	ASC->SetNumericAttributeBase(UAuraAttributeSet::GetResilienceAttribute(), EvalCurve(PrimaryAttributes, Tags.Attributes_Primary_Resilience.GetTagName(), Level));
+	ASC->SetNumericAttributeBase(UAuraAttributeSet::GetVigorAttribute(), EvalCurve(PrimaryAttributes, Tags.Attributes_Primary_Vigor.GetTagName(), Level));
+}
+
+AuraCommandletUtils::FWorld::~FWorld()
+{
+	if (World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+	if (GameInstance)
+	{
+		GameInstance->RemoveFromRoot();
+	}
+}
+
+bool AuraCommandletUtils::FWorld::Initialize(UCharacterClassInfo* CharacterClassInfo, const TCHAR* Caller)
+{
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone(Caller);
+	World = GameInstance->GetWorld();
+
+	World->SetGameMode(FURL(nullptr, TEXT("/Temp/AuraCommandletWorld?game=/Script/Aura.AuraGameModeBase"), TRAVEL_Absolute));
+	AAuraGameModeBase* GameMode = Cast<AAuraGameModeBase>(World->GetAuthGameMode());
+	if (GameMode == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: could not create the Aura Game Mode"), Caller);
+		return false;
+	}
+	GameMode->CharacterClassInfo = CharacterClassInfo;
+	return true;
+}
+
+AAuraBenchmarkCombatant* AuraCommandletUtils::FWorld::SpawnCombatant(int32 Level) const
+{
+	AAuraBenchmarkCombatant* Combatant = World->SpawnActor<AAuraBenchmarkCombatant>();
+	Combatant->Level = Level;
+	Combatant->InitAbilityActorInfo();
+	return Combatant;
+}
@@ -0,0 +1,41 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AAuraBenchmarkCombatant;
+class UAbilitySystemComponent;
+class UCharacterClassInfo;
+class UCurveTable;
+class UGameInstance;
+
+/**
+ * Helpers shared by the headless Aura commandlets.
+ */
+namespace AuraCommandletUtils
+{
+	/** Loads <Project>/Data/<BaseName>.csv, or .json when there is no CSV, into a transient Curve Table. Log category is the caller's name. */
+	UCurveTable* LoadCurveTable(const FString& BaseName, const TCHAR* Caller);
+
+	/** Value of a curve row at Level, 0 if the table or the row is missing. */
+	float EvalCurve(const UCurveTable* CurveTable, FName RowName, float Level);
+
+	/** Sets the base value of the four primary attributes from a CT_PrimaryAttributes_* table. */
+	void SetPrimaryAttributesFromCurves(UAbilitySystemComponent* ASC, const UCurveTable* PrimaryAttributes, float Level);
+
+	/**
+	 * Standalone game world with an Aura Game Mode, so UAuraAbilitySystemLibrary::GetCharacterClassInfo resolves as in game.
+	 */
+	struct FWorld
+	{
+		~FWorld();
+
+		bool Initialize(UCharacterClassInfo* CharacterClassInfo, const TCHAR* Caller);
+
+		AAuraBenchmarkCombatant* SpawnCombatant(int32 Level) const;
+
+		UGameInstance* GameInstance = nullptr;
+		UWorld* World = nullptr;
+	};
+}
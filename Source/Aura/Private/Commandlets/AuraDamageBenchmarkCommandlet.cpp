@@ -0,0 +1,567 @@
+// Giorjorio Copyright
+
+
+#include "Commandlets/AuraDamageBenchmarkCommandlet.h"
+
+#include "AbilitySystemComponent.h"
+#include "AuraAbilityTypes.h"
+#include "AuraGameplayTags.h"
+#include "GameplayEffect.h"
+#include "GameplayEffectExecutionCalculation.h"
+#include "AbilitySystem/AuraAbilitySystemLibrary.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/Data/CharacterClassInfo.h"
+#include "AbilitySystem/ExecCalc/AuraDamageKernel.h"
+#include "AbilitySystem/ExecCalc/AuraDamageRandom.h"
+#include "AbilitySystem/ExecCalc/ExecCalc_Damage.h"
+#include "AbilitySystem/ModMagCalc/MMC_ArcaneResistance.h"
+#include "AbilitySystem/ModMagCalc/MMC_FireResistance.h"
+#include "AbilitySystem/ModMagCalc/MMC_LightningResistance.h"
+#include "AbilitySystem/ModMagCalc/MMC_MaxHealth.h"
+#include "AbilitySystem/ModMagCalc/MMC_MaxMana.h"
+#include "AbilitySystem/ModMagCalc/MMC_PhysicalResistance.h"
+#include "AuraCommandletUtils.h"
+#include "Commandlets/AuraBenchmarkCombatant.h"
+#include "Debug/AuraAllocationCounter.h"
+#include "Dom/JsonObject.h"
+#include "Engine/CurveTable.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/StrongObjectPtr.h"
+
+namespace AuraDamageBenchmark
+{
+	struct FSettings
+	{
+		int32 NumSamples = 200;
+		int32 OpsPerSample = 256;
+		/** Fixed, so the Block / Critical rolls repeat between runs. 0 would mean the per-match seed. */
+		int32 Seed = 1;
+	};
+
+	struct FResult
+	{
+		FString Name;
+		int64 NumItems = 0;
+		double NsPerItem = 0.0;
+		double P50Ns = 0.0;
+		double P99Ns = 0.0;
+		double AllocationsPerItem = 0.0;
+	};
+
+	/**
+	 * Times Op in samples of OpsPerSample calls. Op receives a running index so it can rotate through prepared inputs.
+	 * ItemsPerOp normalizes ops that process several items (batches) to a per-item cost.
+	 * The mean comes from the sample totals. p50 and p99 come from a second pass timing every op on its own, minus the
+	 * cost of reading the clock, so they are per-op latencies (per item for batches) and show the tail.
+	 */
+	template <typename OpType>
+	FResult Run(const FString& Name, const FSettings& Settings, int32 ItemsPerOp, OpType&& Op)
+	{
+		// Warm up caches, lazily built tables and allocator pools
+		for (int32 OpIndex = 0; OpIndex < Settings.OpsPerSample; ++OpIndex)
+		{
+			Op(OpIndex);
+		}
+
+		const double NsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1e9;
+		const int64 ItemsPerSample = int64(Settings.OpsPerSample) * ItemsPerOp;
+		const int64 NumOps = int64(Settings.NumSamples) * Settings.OpsPerSample;
+
+		TArray<double> OpNs;
+		OpNs.SetNumUninitialized(NumOps);
+
+		// Cheapest back to back clock reads, subtracted from every individually timed op
+		uint64 ClockCycles = TNumericLimits<uint64>::Max();
+		for (int32 Calibration = 0; Calibration < 1000; ++Calibration)
+		{
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			ClockCycles = FMath::Min(ClockCycles, FPlatformTime::Cycles64() - StartCycles);
+		}
+
+		const uint64 AllocationsBefore = AuraAllocationCounter::GetThreadAllocationCount();
+		uint64 TotalCycles = 0;
+		int32 OpIndex = 0;
+		for (int32 Sample = 0; Sample < Settings.NumSamples; ++Sample)
+		{
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			for (int32 SampleOp = 0; SampleOp < Settings.OpsPerSample; ++SampleOp)
+			{
+				Op(OpIndex++);
+			}
+			TotalCycles += FPlatformTime::Cycles64() - StartCycles;
+		}
+		const uint64 Allocations = AuraAllocationCounter::GetThreadAllocationCount() - AllocationsBefore;
+
+		for (int64 TimedOp = 0; TimedOp < NumOps; ++TimedOp)
+		{
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Op(OpIndex++);
+			const uint64 ElapsedCycles = FPlatformTime::Cycles64() - StartCycles;
+			OpNs[TimedOp] = double(ElapsedCycles - FMath::Min(ElapsedCycles, ClockCycles)) * NsPerCycle / double(ItemsPerOp);
+		}
+
+		OpNs.Sort();
+		FResult Result;
+		Result.Name = Name;
+		Result.NumItems = ItemsPerSample * Settings.NumSamples;
+		Result.NsPerItem = double(TotalCycles) * NsPerCycle / double(Result.NumItems);
+		Result.P50Ns = OpNs[OpNs.Num() / 2];
+		Result.P99Ns = OpNs[FMath::Clamp(FMath::CeilToInt(OpNs.Num() * 0.99) - 1, 0, OpNs.Num() - 1)];
+		Result.AllocationsPerItem = double(Allocations) / double(Result.NumItems);
+
+		UE_LOG(LogTemp, Display, TEXT("%-64s %10.1f ns/op  p50 %10.1f  p99 %10.1f  %6.2f allocs/op"),
+			*Result.Name, Result.NsPerItem, Result.P50Ns, Result.P99Ns, Result.AllocationsPerItem);
+		return Result;
+	}
+
+	void SetSyntheticAttributes(UAbilitySystemComponent* ASC, FRandomStream& Stream)
+	{
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetStrengthAttribute(), Stream.FRandRange(5.f, 50.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetIntelligenceAttribute(), Stream.FRandRange(5.f, 50.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetResilienceAttribute(), Stream.FRandRange(5.f, 50.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetVigorAttribute(), Stream.FRandRange(5.f, 50.f));
+
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetArmorAttribute(), Stream.FRandRange(0.f, 50.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetArmorPenetrationAttribute(), Stream.FRandRange(0.f, 40.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetBlockChanceAttribute(), Stream.FRandRange(0.f, 30.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetCriticalHitChanceAttribute(), Stream.FRandRange(0.f, 40.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetCriticalHitDamageAttribute(), Stream.FRandRange(0.f, 50.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetCriticalHitResistanceAttribute(), Stream.FRandRange(0.f, 30.f));
+
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetFireResistanceAttribute(), Stream.FRandRange(0.f, 60.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetLightningResistanceAttribute(), Stream.FRandRange(0.f, 60.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetArcaneResistanceAttribute(), Stream.FRandRange(0.f, 60.f));
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetPhysicalResistanceAttribute(), Stream.FRandRange(0.f, 60.f));
+
+		// Large enough that no benchmark kills anyone
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetMaxHealthAttribute(), 1.e9f);
+		ASC->SetNumericAttributeBase(UAuraAttributeSet::GetHealthAttribute(), 1.e9f);
+	}
+
+	/** Instant effect overriding the MMC-driven attributes, the way the Secondary Attributes effect does in game. */
+	UGameplayEffect* MakeDerivedAttributesEffect()
+	{
+		UGameplayEffect* Effect = NewObject<UGameplayEffect>(GetTransientPackage(), TEXT("GE_AuraBenchmarkDerivedAttributes"));
+		Effect->DurationPolicy = EGameplayEffectDurationType::Instant;
+
+		auto AddModifier = [Effect](const FGameplayAttribute& Attribute, TSubclassOf<UGameplayModMagnitudeCalculation> CalculationClass)
+		{
+			FCustomCalculationBasedFloat Calculation;
+			Calculation.CalculationClassMagnitude = CalculationClass;
+
+			FGameplayModifierInfo Modifier;
+			Modifier.Attribute = Attribute;
+			Modifier.ModifierOp = EGameplayModOp::Override;
+			Modifier.ModifierMagnitude = FGameplayEffectModifierMagnitude(Calculation);
+			Effect->Modifiers.Add(Modifier);
+		};
+		AddModifier(UAuraAttributeSet::GetMaxHealthAttribute(), UMMC_MaxHealth::StaticClass());
+		AddModifier(UAuraAttributeSet::GetMaxManaAttribute(), UMMC_MaxMana::StaticClass());
+		AddModifier(UAuraAttributeSet::GetFireResistanceAttribute(), UMMC_FireResistance::StaticClass());
+		AddModifier(UAuraAttributeSet::GetLightningResistanceAttribute(), UMMC_LightningResistance::StaticClass());
+		AddModifier(UAuraAttributeSet::GetArcaneResistanceAttribute(), UMMC_ArcaneResistance::StaticClass());
+		AddModifier(UAuraAttributeSet::GetPhysicalResistanceAttribute(), UMMC_PhysicalResistance::StaticClass());
+		return Effect;
+	}
+
+	UGameplayEffect* MakeDamageEffect()
+	{
+		UGameplayEffect* Effect = NewObject<UGameplayEffect>(GetTransientPackage(), TEXT("GE_AuraBenchmarkDamage"));
+		Effect->DurationPolicy = EGameplayEffectDurationType::Instant;
+
+		FGameplayEffectExecutionDefinition Execution;
+		Execution.CalculationClass = UExecCalc_Damage::StaticClass();
+		Effect->Executions.Add(Execution);
+		return Effect;
+	}
+
+	FGameplayEffectSpecHandle MakeSpec(AAuraBenchmarkCombatant* Source, const UGameplayEffect* Effect)
+	{
+		UAbilitySystemComponent* SourceASC = Source->GetAbilitySystemComponent();
+		FGameplayEffectContextHandle ContextHandle = SourceASC->MakeEffectContext();
+		ContextHandle.AddSourceObject(Source);
+		// The effects are transient instances rather than classes, so the spec is built from the instance directly
+		return FGameplayEffectSpecHandle(new FGameplayEffectSpec(Effect, ContextHandle, Source->Level));
+	}
+
+	/** A damage spec ready to be executed against Target: target attributes are captured like GAS does on application. */
+	struct FDamageCase
+	{
+		AAuraBenchmarkCombatant* Source = nullptr;
+		AAuraBenchmarkCombatant* Target = nullptr;
+		FGameplayEffectSpecHandle SpecHandle;
+	};
+
+	TSharedRef<FJsonObject> ToJson(const FSettings& Settings, const TArray<FResult>& Results)
+	{
+		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetStringField(TEXT("benchmark"), TEXT("AuraDamageBenchmark"));
+		Root->SetNumberField(TEXT("format_version"), 2); // 2: p50 / p99 are per op, not per sample
+		Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+		Root->SetStringField(TEXT("build_version"), FApp::GetBuildVersion());
+		Root->SetStringField(TEXT("build_configuration"), LexToString(FApp::GetBuildConfiguration()));
+		Root->SetStringField(TEXT("platform"), FString(FPlatformProperties::IniPlatformName()));
+		Root->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+
+		TSharedRef<FJsonObject> SettingsObject = MakeShared<FJsonObject>();
+		SettingsObject->SetNumberField(TEXT("samples"), Settings.NumSamples);
+		SettingsObject->SetNumberField(TEXT("ops_per_sample"), Settings.OpsPerSample);
+		SettingsObject->SetNumberField(TEXT("seed"), Settings.Seed);
+		SettingsObject->SetBoolField(TEXT("allocation_tracking"), AuraAllocationCounter::IsEnabled());
+		Root->SetObjectField(TEXT("settings"), SettingsObject);
+
+		TArray<TSharedPtr<FJsonValue>> ResultValues;
+		for (const FResult& Result : Results)
+		{
+			TSharedRef<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+			ResultObject->SetStringField(TEXT("name"), Result.Name);
+			ResultObject->SetNumberField(TEXT("ops"), Result.NumItems);
+			ResultObject->SetNumberField(TEXT("ns_per_op"), Result.NsPerItem);
+			ResultObject->SetNumberField(TEXT("p50_ns"), Result.P50Ns);
+			ResultObject->SetNumberField(TEXT("p99_ns"), Result.P99Ns);
+			ResultObject->SetNumberField(TEXT("allocs_per_op"), Result.AllocationsPerItem);
+			ResultValues.Add(MakeShared<FJsonValueObject>(ResultObject));
+		}
+		Root->SetArrayField(TEXT("results"), ResultValues);
+		return Root;
+	}
+}
+
+UAuraDamageBenchmarkCommandlet::UAuraDamageBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UAuraDamageBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace AuraDamageBenchmark;
+	using namespace AuraCommandletUtils;
+
+	FSettings Settings;
+	FParse::Value(*Params, TEXT("Samples="), Settings.NumSamples);
+	FParse::Value(*Params, TEXT("OpsPerSample="), Settings.OpsPerSample);
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	Settings.NumSamples = FMath::Max(Settings.NumSamples, 1);
+	Settings.OpsPerSample = FMath::Max(Settings.OpsPerSample, 1);
+
+	FString ClassInfoPath = TEXT("/Game/Blueprints/AbilitySystem/Data/DA_CharacterClassInfo.DA_CharacterClassInfo");
+	FParse::Value(*Params, TEXT("ClassInfo="), ClassInfoPath);
+
+	FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), FString::Printf(TEXT("AuraDamageBenchmark-%s.json"), *FDateTime::Now().ToString()));
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	// Allocation counts per op are part of the report
+	AuraAllocationCounter::Enable();
+	// Rolls use the override when it is set, the match seed otherwise: both get the run's seed
+	if (IConsoleVariable* RandomSeedVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("Aura.Damage.RandomSeed")))
+	{
+		RandomSeedVariable->Set(Settings.Seed);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AuraDamageBenchmark: Aura.Damage.RandomSeed not found, the rolls only use the match seed"));
+	}
+	AuraDamageRandom::SetMatchSeed(static_cast<uint32>(Settings.Seed));
+	UExecCalc_Damage::InitializeDamageTypeTable();
+
+	/* Data: the coefficients come with the Character Class Info, damage and primary attributes from <Project>/Data */
+	UCharacterClassInfo* CharacterClassInfo = LoadObject<UCharacterClassInfo>(nullptr, *ClassInfoPath);
+	if (CharacterClassInfo == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("AuraDamageBenchmark: could not load Character Class Info %s"), *ClassInfoPath);
+		return 1;
+	}
+	const TStrongObjectPtr<UCurveTable> DamageCurves(LoadCurveTable(TEXT("CT_Damage"), TEXT("AuraDamageBenchmark")));
+	TArray<TStrongObjectPtr<UCurveTable>> PrimaryAttributeCurves;
+	const UEnum* CharacterClassEnum = StaticEnum<ECharacterClass>();
+	for (int32 ClassIndex = 0; ClassIndex < CharacterClassEnum->NumEnums() - 1; ++ClassIndex)
+	{
+		const FString ClassName = CharacterClassEnum->GetNameStringByIndex(ClassIndex);
+		PrimaryAttributeCurves.Emplace(LoadCurveTable(TEXT("CT_PrimaryAttributes_") + ClassName, TEXT("AuraDamageBenchmark")));
+	}
+
+	FWorld World;
+	if (!World.Initialize(CharacterClassInfo, TEXT("AuraDamageBenchmark"))) return 1;
+
+	const FAuraGameplayTags& Tags = FAuraGameplayTags::Get();
+	const TStrongObjectPtr<UGameplayEffect> DamageEffect(MakeDamageEffect());
+	const TStrongObjectPtr<UGameplayEffect> DerivedAttributesEffect(MakeDerivedAttributesEffect());
+	FRandomStream Stream(Settings.Seed);
+
+	/* Synthetic combatants: random attributes, every damage type */
+	constexpr int32 NumSyntheticCombatants = 16;
+	TArray<AAuraBenchmarkCombatant*> SyntheticCombatants;
+	for (int32 Index = 0; Index < NumSyntheticCombatants; ++Index)
+	{
+		AAuraBenchmarkCombatant* Combatant = World.SpawnCombatant(Stream.RandRange(1, 40));
+		SetSyntheticAttributes(Combatant->GetAbilitySystemComponent(), Stream);
+		SyntheticCombatants.Add(Combatant);
+	}
+
+	TArray<FDamageCase> SyntheticCases;
+	for (int32 Index = 0; Index < NumSyntheticCombatants; ++Index)
+	{
+		FDamageCase& Case = SyntheticCases.AddDefaulted_GetRef();
+		Case.Source = SyntheticCombatants[Index];
+		Case.Target = SyntheticCombatants[(Index + 1) % NumSyntheticCombatants];
+		Case.SpecHandle = MakeSpec(Case.Source, DamageEffect.Get());
+		for (const TTuple<FGameplayTag, FGameplayTag>& Pair : Tags.DamageTypesToResistances)
+		{
+			Case.SpecHandle.Data->SetSetByCallerMagnitude(Pair.Key, Stream.FRandRange(10.f, 200.f));
+		}
+		Case.SpecHandle.Data->CaptureAttributeDataFromTarget(Case.Target->GetAbilitySystemComponent());
+	}
+
+	/* Curve combatants: every class at every level keyed in the curves, primary attributes from the curves, derived ones from the MMCs */
+	const TArray<int32> CurveLevels = { 1, 5, 10, 15, 20, 40 };
+	TArray<AAuraBenchmarkCombatant*> CurveCombatants;
+	TArray<FGameplayEffectSpecHandle> DerivedAttributesSpecs;
+	for (int32 ClassIndex = 0; ClassIndex < PrimaryAttributeCurves.Num(); ++ClassIndex)
+	{
+		for (const int32 Level : CurveLevels)
+		{
+			AAuraBenchmarkCombatant* Combatant = World.SpawnCombatant(Level);
+			UAbilitySystemComponent* ASC = Combatant->GetAbilitySystemComponent();
+			SetSyntheticAttributes(ASC, Stream);
+			SetPrimaryAttributesFromCurves(ASC, PrimaryAttributeCurves[ClassIndex].Get(), Level);
+
+			FGameplayEffectSpecHandle DerivedSpecHandle = MakeSpec(Combatant, DerivedAttributesEffect.Get());
+			ASC->ApplyGameplayEffectSpecToSelf(*DerivedSpecHandle.Data);
+			DerivedSpecHandle.Data->CaptureAttributeDataFromTarget(ASC);
+			DerivedAttributesSpecs.Add(DerivedSpecHandle);
+
+			ASC->SetNumericAttributeBase(UAuraAttributeSet::GetMaxHealthAttribute(), 1.e9f);
+			ASC->SetNumericAttributeBase(UAuraAttributeSet::GetHealthAttribute(), 1.e9f);
+			CurveCombatants.Add(Combatant);
+		}
+	}
+
+	// Each class casts Firebolt at the next class of the same level
+	TArray<FDamageCase> CurveCases;
+	for (int32 Index = 0; Index < CurveCombatants.Num(); ++Index)
+	{
+		FDamageCase& Case = CurveCases.AddDefaulted_GetRef();
+		Case.Source = CurveCombatants[Index];
+		Case.Target = CurveCombatants[(Index + CurveLevels.Num()) % CurveCombatants.Num()];
+		Case.SpecHandle = MakeSpec(Case.Source, DamageEffect.Get());
+		const float FireboltDamage = EvalCurve(DamageCurves.Get(), TEXT("Abilities.Firebolt"), Case.Source->Level);
+		Case.SpecHandle.Data->SetSetByCallerMagnitude(Tags.Damage_Fire, FireboltDamage);
+		Case.SpecHandle.Data->CaptureAttributeDataFromTarget(Case.Target->GetAbilitySystemComponent());
+	}
+
+	TArray<FResult> Results;
+	const UExecCalc_Damage* ExecCalc = GetDefault<UExecCalc_Damage>();
+
+	/* ExecCalc_Damage, called directly */
+	auto RunExecute = [&](const FString& Name, TArray<FDamageCase>& Cases)
+	{
+		TArray<FGameplayEffectCustomExecutionParameters> ExecutionParams;
+		ExecutionParams.Reserve(Cases.Num());
+		for (FDamageCase& Case : Cases)
+		{
+			ExecutionParams.Emplace(*Case.SpecHandle.Data, TArray<FGameplayEffectExecutionScopedModifierInfo>(), Case.Target->GetAbilitySystemComponent(), FGameplayTagContainer(), FPredictionKey());
+		}
+		FGameplayEffectCustomExecutionOutput ExecutionOutput;
+		Results.Add(Run(Name, Settings, 1, [&](int32 OpIndex)
+		{
+			ExecutionOutput.GetOutputModifiersRef().Reset();
+			ExecCalc->Execute_Implementation(ExecutionParams[OpIndex % ExecutionParams.Num()], ExecutionOutput);
+		}));
+	};
+	RunExecute(TEXT("ExecCalc_Damage.Execute (synthetic)"), SyntheticCases);
+	RunExecute(TEXT("ExecCalc_Damage.Execute (curves)"), CurveCases);
+
+	/* ExecCalc_Damage through GAS, as abilities apply it */
+	Results.Add(Run(TEXT("ExecCalc_Damage.ApplyGameplayEffectSpecToTarget (synthetic)"), Settings, 1, [&](int32 OpIndex)
+	{
+		const FDamageCase& Case = SyntheticCases[OpIndex % SyntheticCases.Num()];
+		Case.Source->GetAbilitySystemComponent()->ApplyGameplayEffectSpecToTarget(*Case.SpecHandle.Data, Case.Target->GetAbilitySystemComponent());
+	}));
+
+	TArray<AActor*> BatchTargets(SyntheticCombatants);
+	Results.Add(Run(TEXT("ExecCalc_Damage.ApplyDamageToTargets (synthetic, per target)"), Settings, BatchTargets.Num(), [&](int32 OpIndex)
+	{
+		UExecCalc_Damage::ApplyDamageToTargets(SyntheticCases[OpIndex % SyntheticCases.Num()].SpecHandle, BatchTargets);
+	}));
+
+	/* Damage kernel */
+	{
+		constexpr int32 NumRows = 1024;
+		FAuraDamageBatch Batch;
+		Batch.Reset(Tags.DamageTypesToResistances.Num(), NumRows);
+		TArray<FAuraDamageSourceValues> Sources;
+		TArray<FAuraDamageTargetValues> Targets;
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			FAuraDamageSourceValues& Source = Sources.AddDefaulted_GetRef();
+			FAuraDamageTargetValues& Target = Targets.AddDefaulted_GetRef();
+			Source.NumDamageTypes = Batch.NumDamageTypes;
+			for (int32 TypeIndex = 0; TypeIndex < Source.NumDamageTypes; ++TypeIndex)
+			{
+				Source.DamageByType[TypeIndex] = Stream.FRandRange(0.f, 200.f);
+				Target.ResistanceByType[TypeIndex] = Stream.FRandRange(-10.f, 110.f);
+			}
+			Source.ArmorPenetration = Stream.FRandRange(0.f, 40.f);
+			Source.ArmorPenetrationCoefficient = Stream.FRandRange(0.f, 0.5f);
+			Source.CriticalHitDamage = Stream.FRandRange(0.f, 50.f);
+			Target.Armor = Stream.FRandRange(0.f, 50.f);
+			Target.EffectiveArmorCoefficient = Stream.FRandRange(0.f, 0.5f);
+			Batch.Add(Source, Target, Stream.FRand() < 0.2f, Stream.FRand() < 0.2f);
+		}
+
+		TArray<float> Damage;
+		Damage.SetNumZeroed(NumRows);
+		Results.Add(Run(TEXT("AuraDamageKernel.CalculateDamage"), Settings, 1, [&](int32 OpIndex)
+		{
+			const int32 Row = OpIndex % NumRows;
+			Damage[Row] = AuraDamageKernel::CalculateDamage(Sources[Row], Targets[Row], Batch.Blocked[Row] > 0.f, Batch.Critical[Row] > 0.f);
+		}));
+		Results.Add(Run(TEXT("AuraDamageKernel.CalculateDamageWide (per row)"), Settings, NumRows, [&](int32 OpIndex)
+		{
+			AuraDamageKernel::CalculateDamageWide(Batch, Damage);
+		}));
+	}
+
+	/* MMCs, on the curve combatants' specs */
+	auto RunMMC = [&](const FString& Name, const UGameplayModMagnitudeCalculation* MMC)
+	{
+		float Magnitude = 0.f;
+		Results.Add(Run(Name, Settings, 1, [&](int32 OpIndex)
+		{
+			Magnitude += MMC->CalculateBaseMagnitude_Implementation(*DerivedAttributesSpecs[OpIndex % DerivedAttributesSpecs.Num()].Data);
+		}));
+	};
+	RunMMC(TEXT("MMC_MaxHealth"), GetDefault<UMMC_MaxHealth>());
+	RunMMC(TEXT("MMC_MaxMana"), GetDefault<UMMC_MaxMana>());
+	RunMMC(TEXT("MMC_FireResistance"), GetDefault<UMMC_FireResistance>());
+	RunMMC(TEXT("MMC_LightningResistance"), GetDefault<UMMC_LightningResistance>());
+	RunMMC(TEXT("MMC_ArcaneResistance"), GetDefault<UMMC_ArcaneResistance>());
+	RunMMC(TEXT("MMC_PhysicalResistance"), GetDefault<UMMC_PhysicalResistance>());
+
+	// The six derived modifiers of one effect, as applying the secondary attributes effect evaluates them
+	{
+		const UMMC_DerivedAttribute* DerivedMMCs[] =
+		{
+			GetDefault<UMMC_MaxHealth>(), GetDefault<UMMC_MaxMana>(), GetDefault<UMMC_FireResistance>(),
+			GetDefault<UMMC_LightningResistance>(), GetDefault<UMMC_ArcaneResistance>(), GetDefault<UMMC_PhysicalResistance>()
+		};
+		float Magnitude = 0.f;
+		Results.Add(Run(TEXT("MMC_DerivedAttribute (all six, one spec)"), Settings, 1, [&](int32 OpIndex)
+		{
+			const FGameplayEffectSpec& Spec = *DerivedAttributesSpecs[OpIndex % DerivedAttributesSpecs.Num()].Data;
+			for (const UMMC_DerivedAttribute* MMC : DerivedMMCs)
+			{
+				Magnitude += MMC->CalculateBaseMagnitude_Implementation(Spec);
+			}
+		}));
+	}
+
+	/* FAuraGameplayEffectContext::NetSerialize, with a hit result as projectiles send it */
+	{
+		AAuraBenchmarkCombatant* Source = SyntheticCombatants[0];
+		AAuraBenchmarkCombatant* Target = SyntheticCombatants[1];
+
+		FAuraGameplayEffectContext Context;
+		Context.AddInstigator(Source, Source);
+		Context.AddSourceObject(Source);
+		FHitResult HitResult(Target, nullptr, FVector(120.f, -40.f, 90.f), FVector(0.f, 0.f, 1.f));
+		HitResult.ImpactPoint = HitResult.Location;
+		HitResult.ImpactNormal = HitResult.Normal;
+		HitResult.bBlockingHit = true;
+		Context.AddHitResult(HitResult);
+		Context.SetIsCriticalHit(true);
+
+		const TStrongObjectPtr<UAuraBenchmarkPackageMap> PackageMap(NewObject<UAuraBenchmarkPackageMap>());
+		bool bSuccess = false;
+
+		FNetBitWriter Writer(PackageMap.Get(), 8 * 1024);
+		Results.Add(Run(TEXT("FAuraGameplayEffectContext.NetSerialize (write)"), Settings, 1, [&](int32 OpIndex)
+		{
+			Writer.Reset();
+			Context.NetSerialize(Writer, PackageMap.Get(), bSuccess);
+		}));
+		UE_LOG(LogTemp, Display, TEXT("FAuraGameplayEffectContext serialized size: %lld bits"), Writer.GetNumBits());
+
+		TArray<uint8> Written(Writer.GetData(), Writer.GetNumBytes());
+		FNetBitReader Reader(PackageMap.Get(), Written.GetData(), Writer.GetNumBits());
+		FAuraGameplayEffectContext ReadContext;
+		Results.Add(Run(TEXT("FAuraGameplayEffectContext.NetSerialize (read)"), Settings, 1, [&](int32 OpIndex)
+		{
+			Reader.SetData(Written.GetData(), Writer.GetNumBits());
+			ReadContext.NetSerialize(Reader, PackageMap.Get(), bSuccess);
+		}));
+
+		// Same context in compact hit result mode, as the projectile spells send it
+		FAuraGameplayEffectContext CompactContext = Context;
+		CompactContext.SetUseCompactHitResult(true);
+		FNetBitWriter CompactWriter(PackageMap.Get(), 8 * 1024);
+		Results.Add(Run(TEXT("FAuraGameplayEffectContext.NetSerialize (write, compact hit result)"), Settings, 1, [&](int32 OpIndex)
+		{
+			CompactWriter.Reset();
+			CompactContext.NetSerialize(CompactWriter, PackageMap.Get(), bSuccess);
+		}));
+		UE_LOG(LogTemp, Display, TEXT("FAuraGameplayEffectContext compact serialized size: %lld bits, %lld bytes saved per replicated damage effect"),
+			CompactWriter.GetNumBits(), Writer.GetNumBytes() - CompactWriter.GetNumBytes());
+
+		TArray<uint8> CompactWritten(CompactWriter.GetData(), CompactWriter.GetNumBytes());
+		FNetBitReader CompactReader(PackageMap.Get(), CompactWritten.GetData(), CompactWriter.GetNumBits());
+		Results.Add(Run(TEXT("FAuraGameplayEffectContext.NetSerialize (read, compact hit result)"), Settings, 1, [&](int32 OpIndex)
+		{
+			CompactReader.SetData(CompactWritten.GetData(), CompactWriter.GetNumBits());
+			ReadContext.NetSerialize(CompactReader, PackageMap.Get(), bSuccess);
+		}));
+	}
+
+	/* Wave spawn: enemies spawned with their default attributes (four effect contexts each), then killed off */
+	{
+		FSettings WaveSettings = Settings;
+		WaveSettings.NumSamples = 10;
+		WaveSettings.OpsPerSample = 50;
+
+		const FAuraEffectContextPoolStats Before = FAuraGameplayEffectContext::GetPoolStats();
+		Results.Add(Run(TEXT("Wave spawn (InitializeDefaultAttributes)"), WaveSettings, 1, [&](int32 OpIndex)
+		{
+			AAuraBenchmarkCombatant* Combatant = World.SpawnCombatant(1 + OpIndex % 40);
+			const ECharacterClass CharacterClass = static_cast<ECharacterClass>(OpIndex % 3);
+			UAuraAbilitySystemLibrary::InitializeDefaultAttributes(World.World, CharacterClass, Combatant->Level, Combatant->GetAbilitySystemComponent());
+			Combatant->Destroy();
+		}));
+		const FAuraEffectContextPoolStats After = FAuraGameplayEffectContext::GetPoolStats();
+		UE_LOG(LogTemp, Display, TEXT("Effect context pool during the wave spawn: %lld allocations, %lld served from the pool, peak %lld live"),
+			After.Allocations - Before.Allocations, After.AllocationsAvoided - Before.AllocationsAvoided, After.Peak);
+	}
+
+	/* Report */
+	FString Json;
+	const TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(ToJson(Settings, Results), JsonWriter);
+	if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("AuraDamageBenchmark: could not write %s"), *OutputPath);
+		return 1;
+	}
+	UE_LOG(LogTemp, Display, TEXT("AuraDamageBenchmark: results written to %s"), *OutputPath);
+	return 0;
+}
+
+bool UAuraBenchmarkPackageMap::SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID)
+{
+	uint32 Index = 0;
+	if (Ar.IsSaving())
+	{
+		Index = Obj ? Objects.AddUnique(Obj) + 1 : 0;
+	}
+	Ar.SerializeIntPacked(Index);
+	if (Ar.IsLoading())
+	{
+		Obj = Index > 0 && Objects.IsValidIndex(int32(Index) - 1) ? Objects[Index - 1].Get() : nullptr;
+	}
+	return true;
+}
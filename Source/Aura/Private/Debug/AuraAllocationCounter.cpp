@@ -0,0 +1,124 @@
+// Giorjorio Copyright
+
+
+#include "Debug/AuraAllocationCounter.h"
+
+#include "HAL/MemoryBase.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DelayedAutoRegister.h"
+
+#include <atomic>
+
+#if !UE_BUILD_SHIPPING
+
+namespace AuraAllocationCounter
+{
+	static thread_local uint64 GThreadAllocationCount = 0;
+	static std::atomic<bool> GInstalled = false;
+}
+
+/**
+ * Forwards everything to the wrapped allocator and bumps the calling thread's counter on every allocation.
+ */
+class FAuraCountingMalloc final : public FMalloc
+{
+public:
+	explicit FAuraCountingMalloc(FMalloc* InInnerMalloc) : InnerMalloc(InInnerMalloc) {}
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		++AuraAllocationCounter::GThreadAllocationCount;
+		return InnerMalloc->Malloc(Count, Alignment);
+	}
+
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+	{
+		++AuraAllocationCounter::GThreadAllocationCount;
+		return InnerMalloc->TryMalloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Count > 0)
+		{
+			++AuraAllocationCounter::GThreadAllocationCount;
+		}
+		return InnerMalloc->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Count > 0)
+		{
+			++AuraAllocationCounter::GThreadAllocationCount;
+		}
+		return InnerMalloc->TryRealloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { InnerMalloc->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void InitializeStatsMetadata() override { InnerMalloc->InitializeStatsMetadata(); }
+	virtual void UpdateStats() override { InnerMalloc->UpdateStats(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { InnerMalloc->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { InnerMalloc->DumpAllocatorStats(Ar); }
+	virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+	virtual const TCHAR* GetDescriptiveName() override { return InnerMalloc->GetDescriptiveName(); }
+
+private:
+
+	FMalloc* InnerMalloc;
+};
+
+void AuraAllocationCounter::Enable()
+{
+	bool bExpected = false;
+	if (GInstalled.compare_exchange_strong(bExpected, true))
+	{
+		// Memory allocated before the swap is still freed correctly: the proxy forwards to the same allocator.
+		GMalloc = new FAuraCountingMalloc(GMalloc);
+	}
+}
+
+bool AuraAllocationCounter::IsEnabled()
+{
+	static const bool bRequestedOnCommandLine = FParse::Param(FCommandLine::Get(), TEXT("AuraTrackAllocations"));
+	if (bRequestedOnCommandLine && !GInstalled)
+	{
+		Enable();
+	}
+	return GInstalled;
+}
+
+// Picks up -AuraTrackAllocations as soon as the engine is up
+static FDelayedAutoRegisterHelper GAuraAllocationCounterAutoEnable(EDelayedRegisterRunPhase::EndOfEngineInit, []()
+{
+	AuraAllocationCounter::IsEnabled();
+});
+
+uint64 AuraAllocationCounter::GetThreadAllocationCount()
+{
+	return GThreadAllocationCount;
+}
+
+#else
+
+void AuraAllocationCounter::Enable() {}
+bool AuraAllocationCounter::IsEnabled() { return false; }
+uint64 AuraAllocationCounter::GetThreadAllocationCount() { return 0; }
+
+#endif
+
+FAuraScopedAllocationCounter::FAuraScopedAllocationCounter()
+	: StartCount(AuraAllocationCounter::GetThreadAllocationCount())
+{
+}
+
+uint64 FAuraScopedAllocationCounter::GetNumAllocations() const
+{
+	return AuraAllocationCounter::GetThreadAllocationCount() - StartCount;
+}
@@ -3,3 +3,9 @@
 
 #include "Game/AuraGameModeBase.h"
 
+#include "Game/AuraGameStateBase.h"
+
+AAuraGameModeBase::AAuraGameModeBase()
+{
+	GameStateClass = AAuraGameStateBase::StaticClass();
+}
@@ -0,0 +1,31 @@
+// Giorjorio Copyright
+
+
+#include "Game/AuraGameStateBase.h"
+
+#include "AbilitySystem/ExecCalc/AuraDamageRandom.h"
+#include "Net/UnrealNetwork.h"
+
+void AAuraGameStateBase::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	if (HasAuthority())
+	{
+		// A new sequence of rolls every match
+		DamageRandomSeed = GetTypeHash(FGuid::NewGuid());
+		AuraDamageRandom::SetMatchSeed(DamageRandomSeed);
+	}
+}
+
+void AAuraGameStateBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AAuraGameStateBase, DamageRandomSeed);
+}
+
+void AAuraGameStateBase::OnRep_DamageRandomSeed()
+{
+	AuraDamageRandom::SetMatchSeed(DamageRandomSeed);
+}
@@ -10,3 +10,9 @@ int32 ICombatInterface::GetPlayerLevel()
 {
 	return 0;
 }
+
+EAuraTeam ICombatInterface::GetActorTeam(const AActor* Actor)
+{
+	const ICombatInterface* CombatInterface = Cast<ICombatInterface>(Actor);
+	return CombatInterface ? CombatInterface->GetTeam() : EAuraTeam::None;
+}
@@ -2,6 +2,7 @@
 
 #include "Player/AuraPlayerController.h"
 
+#include "Aura.h"
 #include "AbilitySystem/AuraAbilitySystemComponent.h"
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AuraGameplayTags.h"
@@ -10,10 +11,16 @@
 #include "GameFramework/Character.h"
 #include "Input/AuraInputComponent.h"
 #include "Interaction/EnemyInterface.h"
-#include "NavigationPath.h"
+#include "NavigationData.h"
 #include "NavigationSystem.h"
+#include "NavFilters/NavigationQueryFilter.h"
 #include "UI/Widget/DamageTextComponent.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cursor Traces"), STAT_AuraCursorTraces, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cursor Traces Skipped"), STAT_AuraCursorTracesSkipped, STATGROUP_Aura);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Click To Move Path Latency, Rolling Average (ms)"), STAT_AuraPathLatency, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Click To Move Path Queries Completed"), STAT_AuraPathQueriesCompleted, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Click To Move Paths Superseded"), STAT_AuraPathsSuperseded, STATGROUP_Aura);
 
 AAuraPlayerController::AAuraPlayerController()
 {
@@ -59,9 +66,60 @@ void AAuraPlayerController::AutoRun()
 	}
 }
 
-void AAuraPlayerController::CursorTrace()
+const FHitResult& AAuraPlayerController::GetCursorHit(bool bCurrentFrame)
+{
+	if (bCurrentFrame)
+	{
+		UpdateCursorHit(true);
+	}
+	return CursorHit;
+}
+
+bool AAuraPlayerController::UpdateCursorHit(bool bForce)
 {
+	if (CursorHitFrame == GFrameCounter)
+	{
+		return false;
+	}
+
+	FVector2D CursorPosition = FVector2D::ZeroVector;
+	GetMousePosition(CursorPosition.X, CursorPosition.Y);
+	FVector CameraLocation = FVector::ZeroVector;
+	FRotator CameraRotation = FRotator::ZeroRotator;
+	if (PlayerCameraManager)
+	{
+		PlayerCameraManager->GetCameraViewPoint(CameraLocation, CameraRotation);
+	}
+
+	if (!bForce && CursorHitFrame != 0)
+	{
+		const bool bMoved = CursorPosition != CursorTracePosition
+			|| !CameraLocation.Equals(CursorTraceCameraLocation, 0.1)
+			|| !CameraRotation.Equals(CursorTraceCameraRotation, 0.01);
+		const float Rate = bMoved ? CursorTraceRate : IdleCursorTraceRate;
+		if (Rate > 0.f && GetWorld()->GetRealTimeSeconds() - CursorHitTime < 1.0 / Rate)
+		{
+			INC_DWORD_STAT(STAT_AuraCursorTracesSkipped);
+			return false;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_AuraCursorTraces);
 	GetHitResultUnderCursor(ECC_Visibility, false, CursorHit);
+	CursorHitFrame = GFrameCounter;
+	CursorHitTime = GetWorld()->GetRealTimeSeconds();
+	CursorTracePosition = CursorPosition;
+	CursorTraceCameraLocation = CameraLocation;
+	CursorTraceCameraRotation = CameraRotation;
+	return true;
+}
+
+void AAuraPlayerController::CursorTrace()
+{
+	// A forced trace (GetCursorHit) may already have run this frame, so act on any hit not highlighted yet
+	UpdateCursorHit(false);
+	if (CursorHitFrame == HighlightedCursorHitFrame) return;
+	HighlightedCursorHitFrame = CursorHitFrame;
 	if (!CursorHit.bBlockingHit) return;
 
 	LastActor = ThisActor;
@@ -133,6 +191,7 @@ void AAuraPlayerController::AbilityInputTagPressed(FGameplayTag InputTag)
 	{
 		bTargeting = ThisActor ? true : false;
 		bAutoRunning = false;
+		AbortPathRequest();
 	}
 }
 
@@ -194,28 +253,77 @@ void AAuraPlayerController::AbilityInputTagReleased(FGameplayTag InputTag)
 		const APawn* ControlledPawn = GetPawn();
 		if (FollowTime <= ShortPressThreshold && ControlledPawn)
 		{
-			if (UNavigationPath* NavPath = UNavigationSystemV1::FindPathToLocationSynchronously(this, ControlledPawn->GetActorLocation(), CachedDestination))
-			{
-				Spline->ClearSplinePoints();
-				for (const FVector& PointLoc : NavPath->PathPoints)
-				{
-					Spline->AddSplinePoint(PointLoc, ESplineCoordinateSpace::World);
-				}
-				// So in the case where we would run off into the distance 
-				// is actually a case where we had no path points in the array.  
-				// So just check for that and only start running if we get at least one path point.
-				if (NavPath->PathPoints.Num() > 0)
-				{
-					CachedDestination = NavPath->PathPoints.Last();
-					bAutoRunning = true;
-				}
-			}
+			RequestPathToDestination(ControlledPawn);
 		}
 		FollowTime = 0.f;
 		bTargeting = false;
 	}
 }
 
+void AAuraPlayerController::RequestPathToDestination(const APawn* ControlledPawn)
+{
+	AbortPathRequest();
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (NavSys == nullptr) return;
+	const FNavAgentProperties& AgentProperties = ControlledPawn->GetNavAgentPropertiesRef();
+	const ANavigationData* NavData = NavSys->GetNavDataForProps(AgentProperties, ControlledPawn->GetNavAgentLocation());
+	if (NavData == nullptr) return;
+
+	// Run straight at the destination until the path replaces the spline
+	const FVector Start = ControlledPawn->GetActorLocation();
+	Spline->ClearSplinePoints();
+	Spline->AddSplinePoint(Start, ESplineCoordinateSpace::World);
+	Spline->AddSplinePoint(CachedDestination, ESplineCoordinateSpace::World);
+	bAutoRunning = true;
+
+	FPathFindingQuery Query(this, *NavData, Start, CachedDestination, UNavigationQueryFilter::GetQueryFilter(*NavData, this, nullptr));
+	PathQueryStartTime = FPlatformTime::Seconds();
+	PathQueryId = NavSys->FindPathAsync(AgentProperties, Query, FNavPathQueryDelegate::CreateUObject(this, &AAuraPlayerController::OnPathFound));
+}
+
+void AAuraPlayerController::AbortPathRequest()
+{
+	if (PathQueryId == INVALID_NAVQUERYID) return;
+
+	if (UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()))
+	{
+		NavSys->AbortAsyncFindPathRequest(PathQueryId);
+	}
+	PathQueryId = INVALID_NAVQUERYID;
+	INC_DWORD_STAT(STAT_AuraPathsSuperseded);
+}
+
+void AAuraPlayerController::OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+	// Results of superseded queries can still arrive if they were already done when aborted
+	if (QueryId != PathQueryId) return;
+	PathQueryId = INVALID_NAVQUERYID;
+
+	// Accumulators are not cleared every frame, so the average stays readable between clicks
+	const double LatencyMs = (FPlatformTime::Seconds() - PathQueryStartTime) * 1000.0;
+	PathLatencyAverageMs = NumPathLatencySamples == 0 ? LatencyMs : FMath::Lerp(PathLatencyAverageMs, LatencyMs, 0.1);
+	++NumPathLatencySamples;
+	SET_FLOAT_STAT(STAT_AuraPathLatency, PathLatencyAverageMs);
+	INC_DWORD_STAT(STAT_AuraPathQueriesCompleted);
+
+	if (Result != ENavigationQueryResult::Success || !Path.IsValid() || Path->GetPathPoints().Num() == 0)
+	{
+		// No path, stop where the straight run got us
+		bAutoRunning = false;
+		return;
+	}
+
+	Spline->ClearSplinePoints();
+	for (const FNavPathPoint& PathPoint : Path->GetPathPoints())
+	{
+		Spline->AddSplinePoint(PathPoint.Location, ESplineCoordinateSpace::World);
+	}
+	CachedDestination = Path->GetPathPoints().Last().Location;
+	// The straight run may have stopped against whatever the path goes around
+	bAutoRunning = true;
+}
+
 UAuraAbilitySystemComponent* AAuraPlayerController::GetASC()
 {
 	if (AuraAbilitySystemComponent == nullptr)
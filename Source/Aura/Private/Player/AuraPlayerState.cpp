@@ -30,6 +30,16 @@ UAbilitySystemComponent* AAuraPlayerState::GetAbilitySystemComponent() const
 	return AbilitySystemComponent;
 }
 
+void AAuraPlayerState::SetPlayerLevel(int32 InLevel)
+{
+	Level = InLevel;
+	if (UAuraAbilitySystemComponent* AuraASC = Cast<UAuraAbilitySystemComponent>(AbilitySystemComponent))
+	{
+		// Clients get the re-evaluated attributes through replication, OnRep_Level has nothing to do for them
+		AuraASC->MarkDerivedAttributeLevelDirty();
+	}
+}
+
 void AAuraPlayerState::OnRep_Level(int32 OldLevel)
 {
 	
@@ -0,0 +1,115 @@
+// Giorjorio Copyright
+
+#include "AbilitySystem/ExecCalc/AuraDamageKernel.h"
+#include "Misc/AutomationTest.h"
+
+#include <limits>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AuraDamageKernelTests
+{
+	// Mostly plausible values, with negatives, out of range values and NaN mixed in
+	static float RandomValue(FRandomStream& Stream, float Max)
+	{
+		const int32 Kind = Stream.RandRange(0, 15);
+		switch (Kind)
+		{
+		case 0: return std::numeric_limits<float>::quiet_NaN();
+		case 1: return -Stream.FRandRange(0.f, Max);
+		case 2: return Max + Stream.FRandRange(0.f, Max);
+		case 3: return 0.f;
+		case 4: return -0.f;
+		default: return Stream.FRandRange(0.f, Max);
+		}
+	}
+
+	static void RandomRow(FRandomStream& Stream, int32 NumDamageTypes, FAuraDamageSourceValues& OutSource, FAuraDamageTargetValues& OutTarget)
+	{
+		OutSource.NumDamageTypes = NumDamageTypes;
+		for (int32 TypeIndex = 0; TypeIndex < NumDamageTypes; ++TypeIndex)
+		{
+			OutSource.DamageByType[TypeIndex] = RandomValue(Stream, 200.f);
+			OutTarget.ResistanceByType[TypeIndex] = RandomValue(Stream, 100.f);
+		}
+		OutSource.ArmorPenetration = RandomValue(Stream, 50.f);
+		OutSource.ArmorPenetrationCoefficient = RandomValue(Stream, 1.f);
+		OutSource.CriticalHitDamage = RandomValue(Stream, 50.f);
+		OutTarget.Armor = RandomValue(Stream, 50.f);
+		OutTarget.EffectiveArmorCoefficient = RandomValue(Stream, 1.f);
+	}
+
+	static uint32 ToBits(float Value)
+	{
+		uint32 Bits;
+		FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+		return Bits;
+	}
+
+	// Bit-identical, except that any two NaNs match: C++ does not pin down which NaN payload an operation propagates
+	static bool IsSameResult(float A, float B)
+	{
+		if (FMath::IsNaN(A) || FMath::IsNaN(B))
+		{
+			return FMath::IsNaN(A) && FMath::IsNaN(B);
+		}
+		return ToBits(A) == ToBits(B);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAuraDamageKernelWideMatchesScalarTest, "Aura.DamageKernel.WideMatchesScalar",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAuraDamageKernelWideMatchesScalarTest::RunTest(const FString& Parameters)
+{
+	using namespace AuraDamageKernelTests;
+
+	FRandomStream Stream(0x41757261);
+	FAuraDamageBatch Batch;
+	TArray<FAuraDamageSourceValues> Sources;
+	TArray<FAuraDamageTargetValues> Targets;
+	TArray<bool> Blocked;
+	TArray<bool> Critical;
+	TArray<float> WideDamage;
+
+	int32 NumMismatches = 0;
+	for (int32 Iteration = 0; Iteration < 2000; ++Iteration)
+	{
+		// Every batch size from empty to a few vectors, so the scalar tail is exercised with 0 to LaneWidth - 1 rows
+		const int32 NumRows = Iteration % (AuraDamageKernel::LaneWidth * 4 + 1);
+		const int32 NumDamageTypes = Stream.RandRange(0, AuraDamageKernel::MaxDamageTypes);
+
+		Batch.Reset(NumDamageTypes, NumRows);
+		Sources.SetNum(NumRows);
+		Targets.SetNum(NumRows);
+		Blocked.SetNum(NumRows);
+		Critical.SetNum(NumRows);
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			Sources[Row] = FAuraDamageSourceValues();
+			Targets[Row] = FAuraDamageTargetValues();
+			RandomRow(Stream, NumDamageTypes, Sources[Row], Targets[Row]);
+			Blocked[Row] = Stream.RandRange(0, 1) == 1;
+			Critical[Row] = Stream.RandRange(0, 1) == 1;
+			Batch.Add(Sources[Row], Targets[Row], Blocked[Row], Critical[Row]);
+		}
+
+		WideDamage.SetNumUninitialized(NumRows);
+		AuraDamageKernel::CalculateDamageWide(Batch, WideDamage);
+
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			const float ScalarDamage = AuraDamageKernel::CalculateDamage(Sources[Row], Targets[Row], Blocked[Row], Critical[Row]);
+			if (!IsSameResult(ScalarDamage, WideDamage[Row]) && NumMismatches++ < 10)
+			{
+				AddError(FString::Printf(TEXT("Row %d of a %d row batch: scalar %.9g (0x%08x), wide %.9g (0x%08x)"),
+					Row, NumRows, ScalarDamage, ToBits(ScalarDamage), WideDamage[Row], ToBits(WideDamage[Row])));
+			}
+		}
+	}
+
+	TestEqual(TEXT("Rows where the wide kernel differs from the scalar kernel"), NumMismatches, 0);
+	return true;
+}
+
+#endif
@@ -17,6 +17,9 @@ class AURA_API UAuraDamageGameplayAbility : public UAuraGameplayAbility
 	
 public:
 
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 	
 protected:
 	
@@ -18,13 +18,32 @@ class AURA_API UAuraProjectileSpell : public UAuraDamageGameplayAbility
 
 protected:
 
+	virtual void OnGiveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
 	virtual void ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData) override;
 
 	UFUNCTION(BlueprintCallable, Category = "Projectile")
 	void SpawnProjectile(const FVector& ProjectileTargetLocation);
+
+	/**
+	 * Fires NumProjectiles projectiles fanned across SpreadAngle degrees around the aim.
+	 * They all share one damage spec built for the volley, each only adds its target location when it hits.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Projectile")
+	void SpawnProjectileVolley(const FVector& ProjectileTargetLocation, int32 NumProjectiles, float SpreadAngle);
+
+	/** The damage spec of a volley. Shared by its projectiles, so never modified once built. */
+	virtual FGameplayEffectSpecHandle MakeVolleyDamageSpec();
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	TSubclassOf<AAuraProjectile> ProjectileClass;
 
+	/** Projectiles put in the pool when the ability is granted, so the first casts don't spawn. */
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	int32 NumPrewarmedProjectiles = 8;
+
+private:
+
+	AAuraProjectile* LaunchVolleyProjectile(const FVector& SocketLocation, const FVector& ProjectileTargetLocation, const FGameplayEffectSpecHandle& SpecHandle);
+
 	
 };
@@ -4,8 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "AbilitySystemComponent.h"
+#include "ScalableFloat.h"
+#include "UObject/ObjectKey.h"
 #include "AuraAbilitySystemComponent.generated.h"
 
+class FAuraDerivedAttributeGraph;
+
 
 DECLARE_MULTICAST_DELEGATE_OneParam(FEffectAssetTags, const FGameplayTagContainer& /*AssetTags*/)
 
@@ -27,9 +31,100 @@ public:
 
 	void AbilityInputTagHeld(const FGameplayTag& InputTag);
 	void AbilityInputTagReleased(const FGameplayTag& InputTag);
+
+	virtual void InitializeComponent() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/**
+	 * Index of the next damage execution sourced by this component, used to key the deterministic damage rolls.
+	 * Restarts at 0 for every new prediction key, so a predicting client and the server count the same executions.
+	 * Executions without a prediction key only run on the server: they count from 1 on their own, and ExecCalc_Damage
+	 * sends their index to clients in the effect context.
+	 */
+	uint32 ConsumeDamageExecutionIndex(const FPredictionKey& PredictionKey) const;
+
+	/** Identifies this component in the damage rolls. Assigned by the server, replicated. */
+	uint32 GetDamageRollSourceId() const { return DamageRollSourceId; }
+
+	/*
+	 * Derived Attributes
+	 *
+	 * The UMMC_DerivedAttribute captures are snapshots, so GAS never re-runs a derived modifier on its own. A change
+	 * to a primary attribute or to the level dirties the rows reading it, per FAuraDerivedAttributeGraph. The
+	 * changes of a frame are coalesced: on the next tick, one pass evaluates every row from the current primary
+	 * attributes and level, and only the active effects using a dirty row are re-evaluated, with the pass results
+	 * as SetByCaller magnitudes.
+	 * Server only: the re-evaluated effects and attributes replicate.
+	 */
+
+	/** Server: the level of the avatar changed, re-evaluate the derived attributes reading it. */
+	void MarkDerivedAttributeLevelDirty();
+
+	/** Re-evaluates the effects using dirty derived attributes now instead of on the next tick. */
+	void FlushDerivedAttributes();
+
+	/*
+	 * Outgoing Spec Templates
+	 *
+	 * Specs an ability makes over and over, cached per (ability class, ability level) with their SetByCaller
+	 * magnitudes already evaluated. The ability level is part of the key, so leveling up needs no invalidation.
+	 * In the editor they are dropped when a curve table they read changes or an ability's damage settings are edited.
+	 */
+
+	/**
+	 * New spec of EffectClass at the level of Ability, with SetByCallerMagnitudes evaluated at that level, cloned from
+	 * the cached template. EffectContext replaces the context of the template. An ability class gets one template per
+	 * level, so it must always pass the same EffectClass.
+	 */
+	FGameplayEffectSpecHandle MakeOutgoingSpecFromTemplate(const UGameplayAbility* Ability, TSubclassOf<UGameplayEffect> EffectClass,
+		const TMap<FGameplayTag, FScalableFloat>& SetByCallerMagnitudes, const FGameplayEffectContextHandle& EffectContext);
+
+	void InvalidateSpecTemplates();
+
+	/** Drops the templates of every component, e.g. after a data reload. */
+	static void InvalidateAllSpecTemplates();
 	
 protected:
 
 	UFUNCTION(Client, Reliable)
 	void ClientEffectApplied(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayEffectSpec& EffectSpec, FActiveGameplayEffectHandle ActiveEffectHandle);
+
+private:
+
+	UPROPERTY(Replicated)
+	uint32 DamageRollSourceId = 0;
+
+	// Executions run against a const ASC, hence mutable
+	mutable int16 DamageExecutionPredictionKey = 0;
+	mutable uint32 NextDamageExecutionIndex = 0;
+	mutable uint32 LastUnpredictedDamageExecutionIndex = 0;
+
+	/* Derived Attributes */
+	void InitDerivedAttributeGraph();
+	void OnDerivedAttributeEffectAdded(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayEffectSpec& EffectSpec, FActiveGameplayEffectHandle ActiveEffectHandle);
+	void OnDerivedAttributeInputChanged(const FOnAttributeChangeData& Data);
+	void ScheduleDerivedAttributeFlush();
+
+	/** Built by AbilityActorInfoSet, on the server only. */
+	const FAuraDerivedAttributeGraph* DerivedAttributeGraph = nullptr;
+
+	uint32 DirtyDerivedAttributes = 0;
+	bool bDerivedAttributeFlushPending = false;
+
+	/** Active effects with UMMC_DerivedAttribute modifiers, and the rows they use. */
+	TMap<FActiveGameplayEffectHandle, uint32> DerivedAttributeEffects;
+
+	/* Outgoing Spec Templates */
+	using FSpecTemplateKey = TPair<TObjectKey<UClass>, int32>;
+	TMap<FSpecTemplateKey, TSharedPtr<const FGameplayEffectSpec>> SpecTemplates;
+
+	/** Value of the global generation the templates were built in, see InvalidateAllSpecTemplates. */
+	uint32 SpecTemplatesGeneration = 0;
+
+#if WITH_EDITOR
+	void BindSpecTemplateCurveTable(UCurveTable* CurveTable);
+
+	/** Curve tables whose OnCurveTableChanged drops the templates. */
+	TSet<TWeakObjectPtr<UCurveTable>> SpecTemplateCurveTables;
+#endif
 };
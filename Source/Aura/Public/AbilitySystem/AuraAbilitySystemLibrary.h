@@ -48,7 +48,15 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AuraAbilitySystemLibrary|GameplayEffects")
 	static void SetIsCriticalHit(UPARAM(ref) FGameplayEffectContextHandle& EffectContextHandle, bool bInIsCritical);
 
+	UFUNCTION(BlueprintCallable, Category = "AuraAbilitySystemLibrary|GameplayEffects")
+	static void SetUseCompactHitResult(UPARAM(ref) FGameplayEffectContextHandle& EffectContextHandle, bool bInUseCompactHitResult);
+
+	UFUNCTION(BlueprintCallable, Category = "AuraAbilitySystemLibrary|GameplayEffects")
+	static void ApplyDamageToTargets(const FGameplayEffectSpecHandle& DamageSpecHandle, const TArray<AActor*>& Targets);
+
+	/** Live combatants within Radius of SphereOrigin, only those of Teams unless it is 0. */
 	UFUNCTION(BlueprintCallable, Category = "AuraAbilitySystemLibrary|GameplayMechanics")
-	static void GetLivePlayersWithinRadius(const UObject* WorldContextObject, TArray<AActor*>& OutOverlappingActors, const TArray<AActor*>& ActorsToIgnore, float Radius, const FVector& SphereOrigin);
+	static void GetLivePlayersWithinRadius(const UObject* WorldContextObject, TArray<AActor*>& OutOverlappingActors, const TArray<AActor*>& ActorsToIgnore, float Radius, const FVector& SphereOrigin,
+		UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/Aura.EAuraTeam")) int32 Teams = 0);
 	
 };
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "AttributeSet.h"
 #include "AbilitySystemComponent.h"
+#include "AbilitySystem/AuraReplicatedAttributes.h"
 
 #include "AuraAttributeSet.generated.h"
 
@@ -71,6 +72,8 @@ public:
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	
 	virtual void PreAttributeBaseChange(const FGameplayAttribute& Attribute, float& NewValue) const override;
+	virtual void PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) override;
+	virtual void PostAttributeBaseChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) const override;
 	virtual void PostGameplayEffectExecute(const struct FGameplayEffectModCallbackData& Data) override;
 
 	TMap<FGameplayTag, TStaticFuncPtr<FGameplayAttribute()>> TagsToAttributes;
@@ -264,10 +267,52 @@ public:
 	FGameplayAttributeData IncomingDamage;
 	ATTRIBUTE_ACCESSORS(UAuraAttributeSet, IncomingDamage);
 
+
+	/*
+	 * Simulated Proxies
+	 */
+
+	/*
+	 * Everyone but the owner gets quantized copies instead of the full-precision properties above.
+	 * Health and Mana change on every hit, so they are split from the rest to keep that update small.
+	 */
+
+	/** Health and Mana fractions. */
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedVitals)
+	FAuraReplicatedAttributes ReplicatedVitals;
+
+	UFUNCTION()
+	void OnRep_ReplicatedVitals();
+
+	/** MaxHealth and MaxMana, plus every other attribute when Aura.Net.ReplicateAllAttributesToSimulatedProxies is set. */
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedAttributes)
+	FAuraReplicatedAttributes ReplicatedAttributes;
+
+	UFUNCTION()
+	void OnRep_ReplicatedAttributes();
+
+	/** Requantizes every copied attribute and resends both copies in full. Server only. */
+	void RefreshReplicatedAttributes();
+
+	/** Attribute stored in each FAuraReplicatedAttributes field. */
+	static FGameplayAttribute GetReplicatedAttribute(EAuraReplicatedAttribute Field);
+
 private:
 
 	void SetEffectProperties(const FGameplayEffectModCallbackData& Data, FEffectProperties& Props) const;
 
 	void ShowFloatingText(const FEffectProperties& Props, float Damage, bool bBlockedHit, bool bCriticalHit) const;
+
+	/** Flags a replicated attribute for the push model replication. */
+	void MarkAttributeDirty(const FGameplayAttribute& Attribute) const;
+
+	/** Requantizes Attribute and flags the copy holding it for replication if a simulated proxy would see a change. */
+	void UpdateReplicatedAttributes(const FGameplayAttribute& Attribute);
+
+	/** Writes the quantized copies back into the attributes on a simulated proxy and notifies the listeners. */
+	void ApplyReplicatedAttributes();
+
+	/** Sets an attribute from replication the way GAMEPLAYATTRIBUTE_REPNOTIFY does. */
+	void ApplyReplicatedValue(const FGameplayAttribute& Attribute, float NewValue);
 };
 
@@ -0,0 +1,45 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AttributeSet.h"
+
+class UAuraAttributeSet;
+
+/**
+ * Which derived attributes each attribute feeds, as bit masks of EAuraDerivedAttribute rows.
+ * The nodes are the attributes registered in UAuraAttributeSet::TagsToAttributes, the edges come from the capture
+ * definitions of the UMMC_DerivedAttribute classes: Vigor feeds MaxHealth, Intelligence feeds MaxMana and three
+ * resistances, and so on.
+ */
+class AURA_API FAuraDerivedAttributeGraph
+{
+public:
+
+	/** Built on first use from the registry of AttributeSet. */
+	static const FAuraDerivedAttributeGraph& Get(const UAuraAttributeSet& AttributeSet);
+
+	/** Rows reading Attribute, 0 if nothing derives from it. */
+	uint32 GetDependents(const FGameplayAttribute& Attribute) const;
+
+	/** Rows reading the level. */
+	uint32 GetLevelDependents() const { return LevelDependents; }
+
+	/** Every row. */
+	uint32 GetAllRows() const { return AllRows; }
+
+	/** Attributes feeding at least one row. */
+	const TArray<FGameplayAttribute>& GetInputs() const { return Inputs; }
+
+private:
+
+	explicit FAuraDerivedAttributeGraph(const UAuraAttributeSet& AttributeSet);
+
+	/* Parallel arrays: Dependents[i] are the rows reading Inputs[i] */
+	TArray<FGameplayAttribute> Inputs;
+	TArray<uint32> Dependents;
+
+	uint32 LevelDependents = 0;
+	uint32 AllRows = 0;
+};
@@ -0,0 +1,109 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+
+#include "AuraReplicatedAttributes.generated.h"
+
+/** Attributes FAuraReplicatedAttributes can carry. The mask is sent as a packed integer, so the most frequently changed come first. */
+enum class EAuraReplicatedAttribute : uint8
+{
+	/* Vitals, 16-bit fractions of their max */
+	Health,
+	Mana,
+
+	/* Max vitals and primary attributes, integers */
+	MaxHealth,
+	MaxMana,
+	Strength,
+	Intelligence,
+	Resilience,
+	Vigor,
+
+	/* Ratings, tenths */
+	Armor,
+	ArmorPenetration,
+	CriticalHitDamage,
+	HealthRegeneration,
+	ManaRegeneration,
+
+	/* Chances and resistances, 0.1% fixed point */
+	BlockChance,
+	CriticalHitChance,
+	CriticalHitResistance,
+	FireResistance,
+	LightningResistance,
+	ArcaneResistance,
+	PhysicalResistance,
+
+	Num
+};
+
+/** Totals of the updates FAuraReplicatedAttributes sent, see Aura.Net.AttributeBandwidthReport. */
+struct FAuraReplicatedAttributesNetStats
+{
+	uint64 NumUpdates = 0;
+	uint64 NumFullUpdates = 0;
+	uint64 NumFields = 0;
+	uint64 NumBits = 0;
+};
+
+/**
+ * Quantized, bit-packed attribute values, replicated to simulated proxies in place of the per-property
+ * FGameplayAttributeData (two full floats each).
+ *
+ * Values are quantized when set, so the server only resends when a client could see the difference:
+ * - Health and Mana are 16-bit fractions of MaxHealth and MaxMana
+ * - max vitals and primary attributes are packed integers
+ * - ratings and regeneration are packed tenths
+ * - chances and resistances are fixed-point percentages with 0.1% steps, clamped to [0, 100]
+ * Each connection keeps the values it was last sent, so an update only carries the fields that changed since,
+ * behind a leading packed mask of those fields. The first update to a connection carries the non-zero fields.
+ */
+USTRUCT()
+struct AURA_API FAuraReplicatedAttributes
+{
+	GENERATED_BODY()
+
+	static constexpr int32 NumFields = static_cast<int32>(EAuraReplicatedAttribute::Num);
+
+	/**
+	 * Quantizes and stores Value. MaxValue is only read for Health and Mana.
+	 * @return true if the quantized value changed.
+	 */
+	bool Set(EAuraReplicatedAttribute Field, float Value, float MaxValue = 0.f);
+
+	/** Dequantized value. For Health and Mana this is the fraction of their max. */
+	float Get(EAuraReplicatedAttribute Field) const;
+
+	/** True if the field is non-zero. */
+	bool Has(EAuraReplicatedAttribute Field) const { return Quantized[static_cast<int32>(Field)] != 0; }
+
+	/** Sends every field on the next update to each connection, whatever it was sent before. */
+	void ForceFullResend() { ++FullResendGeneration; }
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+
+	/** What NetDeltaSerialize actually wrote on this process since the last ResetNetStats. */
+	static const FAuraReplicatedAttributesNetStats& GetNetStats();
+	static void ResetNetStats();
+
+private:
+
+	/** Quantized values, indexed by EAuraReplicatedAttribute. */
+	uint32 Quantized[NumFields] = {};
+
+	/** Bumped by ForceFullResend. Not replicated, compared against the generation each connection was last sent. */
+	uint8 FullResendGeneration = 0;
+};
+
+template<>
+struct TStructOpsTypeTraits<FAuraReplicatedAttributes> : public TStructOpsTypeTraitsBase2<FAuraReplicatedAttributes>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -8,6 +8,7 @@
 
 class UGameplayAbility;
 class UGameplayEffect;
+struct FRealCurve;
 
 UENUM(BlueprintType)
 enum class ECharacterClass : uint8
@@ -58,5 +59,43 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Common Class Defaults|Damage")
 	TObjectPtr<UCurveTable> DamageCalculationCoefficients;
 
+	/** Coefficients are baked for levels 1..MaxCoefficientLevel (or the last curve key, if higher). Higher levels use the last entry. */
+	UPROPERTY(EditDefaultsOnly, Category = "Common Class Defaults|Damage", meta = (ClampMin = 1))
+	int32 MaxCoefficientLevel = 40;
+
 	FCharacterClassDefaultInfo GetClassDefaultInfo(ECharacterClass CharacterClass) const;
+
+	/* Damage Calculation Coefficients, read from the per-level tables baked at load. Missing curves bake zeros. */
+	float GetArmorPenetrationCoefficient(int32 Level) const;
+	float GetEffectiveArmorCoefficient(int32 Level) const;
+	float GetCriticalHitResistanceCoefficient(int32 Level) const;
+
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual EDataValidationResult IsDataValid(FDataValidationContext& Context) const override;
+#endif
+
+private:
+
+	/** ArmorPenetration, EffectiveArmor and CriticalHitResistance, null where the row is missing. Reports every missing row. */
+	TArray<const FRealCurve*> FindDamageCalculationCoefficientCurves(TArray<FString>& OutErrors) const;
+
+	/** Resolves the coefficient curves once and samples them per level. Returns false, with the errors, if a curve row is missing. */
+	bool BakeDamageCalculationCoefficients(TArray<FString>& OutErrors);
+
+	/** Reads a baked coefficient, the last entry past the end. */
+	static float GetCoefficient(const TArray<float>& Coefficients, int32 Level);
+
+	/* Index 0 is level 1 */
+	TArray<float> ArmorPenetrationCoefficients;
+	TArray<float> EffectiveArmorCoefficients;
+	TArray<float> CriticalHitResistanceCoefficients;
+
+#if WITH_EDITOR
+	/** Bakes again after an edit, logging the missing rows. */
+	void RebakeDamageCalculationCoefficients();
+
+	TWeakObjectPtr<UCurveTable> BoundCoefficientsTable;
+#endif
 };
@@ -0,0 +1,83 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * AuraDamageKernel
+ *
+ * The damage formula of ExecCalc_Damage as pure C++, with no GAS dependency:
+ * per-type resistance, block halving, armor / armor penetration with their coefficients, critical doubling plus bonus.
+ * The scalar version serves the GAS execution. The wide version runs 4 lanes at a time on struct-of-arrays data
+ * and serves bulk callers (batched AoE, periodic ticks, tuning tools).
+ * Both versions perform the same IEEE operations in the same order (no fused multiply-add) and clamp with the same
+ * compare + select semantics, so their results are bit-identical. AuraDamageKernelTests checks this.
+ */
+namespace AuraDamageKernel
+{
+	/** Upper bound on the number of damage types the kernel supports. */
+	static constexpr int32 MaxDamageTypes = 8;
+
+	/** Number of lanes processed per iteration by the wide kernel. */
+	static constexpr int32 LaneWidth = 4;
+}
+
+/** Attacker side of the formula. */
+struct FAuraDamageSourceValues
+{
+	int32 NumDamageTypes = 0;
+	float DamageByType[AuraDamageKernel::MaxDamageTypes] = {}; // Same order as the damage type table of ExecCalc_Damage
+	float ArmorPenetration = 0.f;
+	float ArmorPenetrationCoefficient = 0.f;
+	float CriticalHitChance = 0.f;
+	float CriticalHitDamage = 0.f;
+};
+
+/** Defender side of the formula. */
+struct FAuraDamageTargetValues
+{
+	float ResistanceByType[AuraDamageKernel::MaxDamageTypes] = {}; // Same order as FAuraDamageSourceValues::DamageByType
+	float Armor = 0.f;
+	float EffectiveArmorCoefficient = 0.f;
+	float BlockChance = 0.f;
+	float CriticalHitResistance = 0.f;
+	float CriticalHitResistanceCoefficient = 0.f;
+};
+
+/**
+ * Struct-of-arrays input of the wide kernel. One row per damage instance.
+ */
+struct AURA_API FAuraDamageBatch
+{
+	/** Clears all rows and sets how many damage types every row carries. */
+	void Reset(int32 InNumDamageTypes, int32 ExpectedRows = 0);
+
+	/** Appends one damage instance and returns its row index. */
+	int32 Add(const FAuraDamageSourceValues& Source, const FAuraDamageTargetValues& Target, bool bBlocked, bool bCritical);
+
+	int32 Num() const { return Armor.Num(); }
+
+	int32 NumDamageTypes = 0;
+	TArray<float> DamageByType[AuraDamageKernel::MaxDamageTypes];
+	TArray<float> ResistanceByType[AuraDamageKernel::MaxDamageTypes];
+	TArray<float> ArmorPenetration;
+	TArray<float> ArmorPenetrationCoefficient;
+	TArray<float> Armor;
+	TArray<float> EffectiveArmorCoefficient;
+	TArray<float> CriticalHitDamage;
+	TArray<float> Blocked; // 1 if the hit was blocked, 0 otherwise
+	TArray<float> Critical; // 1 if the hit was critical, 0 otherwise
+};
+
+namespace AuraDamageKernel
+{
+	/** Critical Hit Resistance reduces a percentage of the Source's Critical Hit Chance. */
+	AURA_API float CalculateEffectiveCriticalHitChance(const FAuraDamageSourceValues& Source, const FAuraDamageTargetValues& Target);
+
+	/** Damage of a single hit. */
+	AURA_API float CalculateDamage(const FAuraDamageSourceValues& Source, const FAuraDamageTargetValues& Target, bool bBlocked, bool bCritical);
+
+	/** Damage of every row of the batch. OutDamage must hold Batch.Num() values. */
+	AURA_API void CalculateDamageWide(const FAuraDamageBatch& Batch, TArrayView<float> OutDamage);
+}
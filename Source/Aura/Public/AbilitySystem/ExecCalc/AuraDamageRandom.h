@@ -0,0 +1,63 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAbilitySystemComponent;
+
+/**
+ * AuraDamageRandom
+ *
+ * Stateless, counter-based random numbers for the Block and Critical rolls of ExecCalc_Damage.
+ * A roll is a pure function of (match seed, source id, prediction key, execution index, stream), hashed with SplitMix64,
+ * so the server and the owning client compute the same outcome for the same predicted execution,
+ * and a benchmark run with a fixed seed (Aura.Damage.RandomSeed) is repeatable.
+ * Every input is replicated: the seed by AAuraGameStateBase, the source id by the source's ability system component,
+ * and the execution index of executions without a prediction key by their effect context.
+ */
+namespace AuraDamageRandom
+{
+	/** Independent streams drawn from the same key. */
+	enum class EStream : uint32
+	{
+		Block = 0,
+		Critical = 1
+	};
+
+	/** SplitMix64 finalizer: a bijective 64 bit mix with full avalanche. */
+	inline uint64 Mix(uint64 Value)
+	{
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	/** Aura.Damage.RandomSeed if set, the seed of the current match otherwise. */
+	AURA_API uint32 GetSeed();
+
+	/** Called with the seed the server drew for the match, on the server and on every client. */
+	AURA_API void SetMatchSeed(uint32 MatchSeed);
+
+	/** Identifier of the source that the server and every client agree on: the replicated roll id of its ability system component. */
+	AURA_API uint32 GetSourceId(const UAbilitySystemComponent* SourceASC);
+
+	/** Combines every input of a roll into a single 64 bit key. */
+	inline uint64 MakeKey(uint32 SourceId, int16 PredictionKey, uint32 ExecutionIndex)
+	{
+		uint64 Key = Mix((uint64(GetSeed()) << 32) | SourceId);
+		Key = Mix(Key ^ ((uint64(uint16(PredictionKey)) << 32) | ExecutionIndex));
+		return Key;
+	}
+
+	/** Uniform value in [UE_SMALL_NUMBER, 100), the same range the rolls used with FMath::FRandRange. */
+	inline float RollPercent(uint64 Key, EStream Stream)
+	{
+		// Golden ratio increment per stream, as SplitMix64 does per step
+		const uint64 Bits = Mix(Key + 0x9E3779B97F4A7C15ull * (uint64(Stream) + 1));
+
+		// Top 24 bits give every representable float in [0, 1) the same weight
+		const float Unit = float(Bits >> 40) * (1.f / 16777216.f);
+		return UE_SMALL_NUMBER + Unit * (100.f - UE_SMALL_NUMBER);
+	}
+}
@@ -4,8 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "GameplayEffectExecutionCalculation.h"
+#include "GameplayEffectTypes.h"
 #include "ExecCalc_Damage.generated.h"
 
+class UCharacterClassInfo;
+struct FAuraDamageSourceValues;
+struct FAuraDamageTargetValues;
+
 /**
  * 
  */
@@ -17,6 +22,25 @@ class AURA_API UExecCalc_Damage : public UGameplayEffectExecutionCalculation
 public:
 	UExecCalc_Damage();
 
+	/** Builds the damage type table used by Execute. Call once the native Gameplay Tags exist. */
+	static void InitializeDamageTypeTable();
+
+	/**
+	 * Applies one damage spec to many targets (AoE). Source attributes and coefficients are evaluated once for the whole
+	 * batch, then each target gets its own Block/Critical roll and the resolved damage through one shared instant
+	 * IncomingDamage spec. Only the damage is applied, the rest of the damage effect is not. Server only.
+	 */
+	static void ApplyDamageToTargets(const FGameplayEffectSpecHandle& DamageSpecHandle, const TArray<AActor*>& Targets);
+
+	/** Index of a damage type in FAuraDamageSourceValues::DamageByType, or INDEX_NONE. */
+	static int32 FindDamageTypeIndex(const FGameplayTag& DamageTypeTag);
+
+	/** Reads the attacker side of the formula from the current attribute values of an ASC. Damage amounts are left untouched. */
+	static void ReadSourceValues(const UAbilitySystemComponent* SourceASC, int32 SourceLevel, const UCharacterClassInfo* CharacterClassInfo, FAuraDamageSourceValues& OutSource);
+
+	/** Reads the defender side of the formula from the current attribute values of an ASC. */
+	static void ReadTargetValues(const UAbilitySystemComponent* TargetASC, int32 TargetLevel, const UCharacterClassInfo* CharacterClassInfo, FAuraDamageTargetValues& OutTarget);
+
 	virtual void Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const override;
 	
 };
@@ -3,25 +3,18 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "GameplayModMagnitudeCalculation.h"
+#include "AbilitySystem/ModMagCalc/MMC_DerivedAttribute.h"
 #include "MMC_ArcaneResistance.generated.h"
 
 /**
  * 
  */
 UCLASS()
-class AURA_API UMMC_ArcaneResistance : public UGameplayModMagnitudeCalculation
+class AURA_API UMMC_ArcaneResistance : public UMMC_DerivedAttribute
 {
 	GENERATED_BODY()
 
 public:
 	UMMC_ArcaneResistance();
-
-	virtual float CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const override;
-
-private:
-	
-	FGameplayEffectAttributeCaptureDefinition IntelligenceDef;
-	FGameplayEffectAttributeCaptureDefinition ResilienceDef;
 	
 };
@@ -0,0 +1,87 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayModMagnitudeCalculation.h"
+#include "MMC_DerivedAttribute.generated.h"
+
+/** Attributes derived from the primary attributes, one formula row each. */
+enum class EAuraDerivedAttribute : uint8
+{
+	MaxHealth,
+	MaxMana,
+	FireResistance,
+	LightningResistance,
+	ArcaneResistance,
+	PhysicalResistance,
+
+	Num
+};
+
+/** What every derived attribute formula reads: the four primary attributes, clamped to 0, and the level. */
+struct FAuraDerivedAttributeInputs
+{
+	float Strength = 0.f;
+	float Intelligence = 0.f;
+	float Resilience = 0.f;
+	float Vigor = 0.f;
+	int32 Level = 1;
+};
+
+/**
+ * One derived attribute formula:
+ * (Resilience * ResilienceCoefficient + Intelligence * IntelligenceCoefficient + Strength * StrengthCoefficient + Vigor * VigorCoefficient) * Scale
+ * + Level * LevelCoefficient + Constant
+ */
+struct FAuraDerivedAttributeFormula
+{
+	float ResilienceCoefficient = 0.f;
+	float IntelligenceCoefficient = 0.f;
+	float StrengthCoefficient = 0.f;
+	float VigorCoefficient = 0.f;
+	float Scale = 1.f;
+	float LevelCoefficient = 0.f;
+	float Constant = 0.f;
+};
+
+/**
+ * Table-driven calculation shared by every attribute derived from the primary attributes.
+ * Each subclass picks its formula row and captures only the primary attributes that row reads, which is what
+ * FAuraDerivedAttributeGraph builds its edges from.
+ *
+ * The captures are snapshots. Once the effect is applied, UAuraAbilitySystemComponent re-evaluates it when an
+ * input changes, passing every row from one pass over the target's attributes as SetByCaller magnitudes, which
+ * the calculation returns instead of its own formula. On application, each modifier evaluates only its own row.
+ */
+UCLASS(Abstract)
+class AURA_API UMMC_DerivedAttribute : public UGameplayModMagnitudeCalculation
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual float CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const override;
+
+	EAuraDerivedAttribute GetDerivedAttribute() const { return DerivedAttribute; }
+
+	static const FAuraDerivedAttributeFormula& GetFormula(EAuraDerivedAttribute DerivedAttribute);
+
+	/** SetByCaller tag the value of a row is passed in, the tag of the attribute it derives. */
+	static FGameplayTag GetSetByCallerTag(EAuraDerivedAttribute DerivedAttribute);
+
+	/** Evaluates the formula row of DerivedAttribute on Inputs. */
+	static float Evaluate(EAuraDerivedAttribute DerivedAttribute, const FAuraDerivedAttributeInputs& Inputs);
+
+	/** Evaluates every formula row on Inputs. */
+	static void EvaluateAll(const FAuraDerivedAttributeInputs& Inputs, float (&OutValues)[static_cast<int32>(EAuraDerivedAttribute::Num)]);
+
+protected:
+
+	/** Selects the row this calculation returns and captures the primary attributes it reads. Called by the subclass constructors. */
+	void SetDerivedAttribute(EAuraDerivedAttribute InDerivedAttribute);
+
+private:
+
+	EAuraDerivedAttribute DerivedAttribute = EAuraDerivedAttribute::MaxHealth;
+};
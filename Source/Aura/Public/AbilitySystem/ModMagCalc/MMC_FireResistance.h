@@ -3,25 +3,18 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "GameplayModMagnitudeCalculation.h"
+#include "AbilitySystem/ModMagCalc/MMC_DerivedAttribute.h"
 #include "MMC_FireResistance.generated.h"
 
 /**
  * 
  */
 UCLASS()
-class AURA_API UMMC_FireResistance : public UGameplayModMagnitudeCalculation
+class AURA_API UMMC_FireResistance : public UMMC_DerivedAttribute
 {
 	GENERATED_BODY()
 
 public:
 	UMMC_FireResistance();
-
-	virtual float CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const override;
-
-private:
-
-	FGameplayEffectAttributeCaptureDefinition IntelligenceDef;
-	FGameplayEffectAttributeCaptureDefinition ResilienceDef;
 	
 };
@@ -3,24 +3,18 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "GameplayModMagnitudeCalculation.h"
+#include "AbilitySystem/ModMagCalc/MMC_DerivedAttribute.h"
 #include "MMC_MaxMana.generated.h"
 
 /**
  * 
  */
 UCLASS()
-class AURA_API UMMC_MaxMana : public UGameplayModMagnitudeCalculation
+class AURA_API UMMC_MaxMana : public UMMC_DerivedAttribute
 {
 	GENERATED_BODY()
 
 public:
 	UMMC_MaxMana();
-
-	virtual float CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const override;
-
-private:
-
-	FGameplayEffectAttributeCaptureDefinition IntelligenceDef;
 	
 };
@@ -3,24 +3,18 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "GameplayModMagnitudeCalculation.h"
+#include "AbilitySystem/ModMagCalc/MMC_DerivedAttribute.h"
 #include "MMC_PhysicalResistance.generated.h"
 
 /**
  * 
  */
 UCLASS()
-class AURA_API UMMC_PhysicalResistance : public UGameplayModMagnitudeCalculation
+class AURA_API UMMC_PhysicalResistance : public UMMC_DerivedAttribute
 {
 	GENERATED_BODY()
 
 public:
 	UMMC_PhysicalResistance();
-
-	virtual float CalculateBaseMagnitude_Implementation(const FGameplayEffectSpec& Spec) const override;
-
-private:
-
-	FGameplayEffectAttributeCaptureDefinition ResilienceDef;
-	FGameplayEffectAttributeCaptureDefinition StrengthDef;
+	
 };
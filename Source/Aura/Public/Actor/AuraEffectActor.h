@@ -38,6 +38,7 @@ public:
 	
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UFUNCTION(BlueprintCallable)
 	void ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGameplayEffect> GameplayEffectClass);
@@ -83,10 +84,28 @@ protected:
 	EEffectRemovalPolicy InfiniteEffectRemovalPolicy = EEffectRemovalPolicy::RemoveOnEndOverlap;
 	/* Infinite end */
 	
-	TMap<FActiveGameplayEffectHandle, UAbilitySystemComponent*> ActiveEffectHandles;
+	/** Infinite effects to remove on end overlap, by target. */
+	TMultiMap<TWeakObjectPtr<UAbilitySystemComponent>, FActiveGameplayEffectHandle> ActiveEffectHandles;
+
+	/** Removes the tracked effects from every target, when the actor goes away with targets still inside. */
+	void RemoveAllActiveEffects();
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects")
 	float ActorLevel = 1.f;
-	
+
+	/* Zone */
+
+	/**
+	 * Let UAuraEffectZoneSubsystem detect combatants inside ZoneExtent instead of collision overlaps.
+	 * The actor's collision is disabled, for static zones only.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Zone")
+	bool bUseZoneManager = false;
+
+	/** Half size of the zone box around the actor. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Zone", meta = (EditCondition = "bUseZoneManager"))
+	FVector ZoneExtent = FVector(100.f);
+
+	friend class UAuraEffectZoneSubsystem;
 	
 };
@@ -0,0 +1,59 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraEffectZoneSubsystem.generated.h"
+
+class AAuraEffectActor;
+
+/**
+ * Area effect zones tested against the combatants at a fixed rate instead of with collision overlaps.
+ * Zones are static boxes bucketed in a uniform XY grid. Every update each combatant's capsule is tested against the
+ * zones of the cells it covers only, and entering or leaving a zone calls the OnOverlap / OnEndOverlap of its
+ * AAuraEffectActor, so the application and removal policies work as with collision. Server only.
+ */
+UCLASS()
+class AURA_API UAuraEffectZoneSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Starts testing combatants against the bounds of ZoneActor. */
+	void RegisterZone(AAuraEffectActor* ZoneActor, const FBox& Bounds);
+
+	/** Stops testing ZoneActor. Its occupants get no end overlap. */
+	void UnregisterZone(AAuraEffectActor* ZoneActor);
+
+	virtual void Deinitialize() override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	struct FZone
+	{
+		TWeakObjectPtr<AAuraEffectActor> Actor;
+		FBox Bounds;
+		FIntPoint MinCell;
+		FIntPoint MaxCell;
+
+		/** Combatants inside as of the last update. */
+		TArray<TWeakObjectPtr<AActor>> Occupants;
+	};
+
+	/** Stable indices, the grid refers to zones by index. */
+	TSparseArray<FZone> Zones;
+	TMap<FIntPoint, TArray<int32>> Grid;
+	float CellSize = 1000.f;
+
+	FTimerHandle UpdateTimer;
+
+	void UpdateZones();
+
+	FIntPoint GetCell(const FVector& Location) const;
+};
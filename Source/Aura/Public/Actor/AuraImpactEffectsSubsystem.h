@@ -0,0 +1,63 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraImpactEffectsSubsystem.generated.h"
+
+class UNiagaraSystem;
+class USoundBase;
+
+/** One impact waiting for the end of the frame. */
+struct FAuraImpactEffectRequest
+{
+	TObjectPtr<UNiagaraSystem> Effect;
+	TObjectPtr<USoundBase> Sound;
+	FVector Location;
+
+	/** Squared distance to the closest local viewer, filled in when the frame is flushed. */
+	float ViewDistanceSquared = 0.f;
+};
+
+/**
+ * Budget for projectile impact and looping effects on machines that render.
+ * Impacts are queued, merged when the same effect lands at nearly the same spot in the same frame, culled by distance
+ * to the local viewers and by occlusion, and at most Aura.ImpactEffects.MaxPerFrame of them play, closest first.
+ * Niagara components come from the world component pool, looping sounds are capped.
+ */
+UCLASS()
+class AURA_API UAuraImpactEffectsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Queues an impact at Location. Either asset may be null. */
+	void PlayImpact(UNiagaraSystem* Effect, USoundBase* Sound, const FVector& Location);
+
+	/** Whether a looping sound may start at Location. Every granted sound must be released. */
+	bool AcquireLoopingSound(const FVector& Location);
+	void ReleaseLoopingSound();
+
+	/* UTickableWorldSubsystem */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	/** Eye locations of the local players, refreshed every frame. */
+	TArray<FVector> ViewLocations;
+
+	void UpdateViewLocations();
+	float GetViewDistanceSquared(const FVector& Location) const;
+	bool IsOccluded(const FVector& Location) const;
+
+	TArray<FAuraImpactEffectRequest> PendingImpacts;
+
+	int32 NumLoopingSounds = 0;
+};
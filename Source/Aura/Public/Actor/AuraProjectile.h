@@ -4,21 +4,101 @@
 
 #include "CoreMinimal.h"
 #include "GameplayEffectTypes.h"
+#include "Engine/NetSerialization.h"
 #include "GameFramework/Actor.h"
 #include "AuraProjectile.generated.h"
 
 class USphereComponent;
 class UProjectileMovementComponent;
 class UNiagaraSystem;
+class UAbilitySystemComponent;
 
+/** How the server finds what a projectile hits. */
+UENUM()
+enum class EAuraProjectileHitMode : uint8
+{
+	/** Sphere overlap events. The server still moves the projectile in UAuraProjectileSimulationSubsystem when it is batched. */
+	Overlap,
+	/** One sphere sweep per step against ECC_Combat in UAuraProjectileSimulationSubsystem, no overlap events. */
+	Sweep
+};
+
+/** Totals for comparing the hit modes, printed by Aura.Projectile.HitStats. Game thread only. */
+struct FAuraProjectileHitStats
+{
+	uint64 OverlapEvents = 0;
+	uint64 Sweeps = 0;
+	uint64 Hits = 0;
+	uint64 Expired = 0;
+
+	/** Expired projectiles whose straight path from launch crosses something they should have hit. */
+	uint64 MissedHits = 0;
+
+	double StartTime = 0.0;
+
+	static FAuraProjectileHitStats& Get();
+};
+
+/** Replicated flight state of a pooled projectile. */
+USTRUCT()
+struct FAuraProjectilePoolState
+{
+	GENERATED_BODY()
+
+	/** False while the projectile waits in the pool. */
+	UPROPERTY()
+	bool bActive = true;
+
+	/** Bumped on every launch from the pool, so a client that missed the return still restarts the flight. */
+	UPROPERTY()
+	uint8 LaunchCount = 0;
+
+	UPROPERTY()
+	FVector_NetQuantize10 LaunchLocation = FVector::ZeroVector;
+
+	UPROPERTY()
+	FRotator LaunchRotation = FRotator::ZeroRotator;
+
+	/** Server world time of the launch, lets late clients start the flight where the projectile already is. */
+	UPROPERTY()
+	float LaunchTime = 0.f;
+};
+
+/** Everything a client needs to simulate a client simulated projectile on its own. */
+USTRUCT()
+struct FAuraProjectileSpawnEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint32 ProjectileId = 0;
+
+	UPROPERTY()
+	TSubclassOf<AAuraProjectile> ProjectileClass;
+
+	UPROPERTY()
+	FVector_NetQuantize10 Origin = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction = FVector::ForwardVector;
+
+	UPROPERTY()
+	float Speed = 0.f;
+
+	/** Server world time of the launch, lets late clients start the projectile where it already is. */
+	UPROPERTY()
+	float SpawnTime = 0.f;
+};
 
 UCLASS()
 class AURA_API AAuraProjectile : public AActor
 {
 	GENERATED_BODY()
-	
-public:	
+
+public:
 	AAuraProjectile();
+	virtual void PostInitProperties() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	UPROPERTY(VisibleAnywhere)
 	TObjectPtr<UProjectileMovementComponent> ProjectileMovement;
@@ -26,20 +106,99 @@ public:
 	UPROPERTY(BlueprintReadWrite, meta = (ExposeOnSpawn = true))
 	FGameplayEffectSpecHandle DamageEffectSpecHandle;
 
+	/**
+	 * Sets a damage spec shared with other projectiles, which is never copied. What is specific to this projectile,
+	 * itself as source object and TargetLocation as hit result, goes on a context of its own, made once here.
+	 */
+	void SetSharedDamageSpec(const FGameplayEffectSpecHandle& SharedSpecHandle, const FVector& TargetLocation);
+
+	/*
+	 * Pooling, see UAuraProjectilePoolSubsystem.
+	 * A pooled projectile goes back to the pool on hit or when its life span runs out, instead of being destroyed.
+	 */
+
+	/** Set by the pool on the projectiles it owns. */
+	void SetPooled() { bPooled = true; }
+
+	/** Server: makes a deferred spawn start out waiting in the pool, hidden, without collision and net dormant. */
+	void InitDormant();
+
+	/** Server: puts a pooled projectile back in flight from SpawnTransform. */
+	void LaunchFromPool(const FTransform& SpawnTransform);
+
+	/** Server: ends the flight and hands the projectile back to its pool, or destroys it if it has none. */
+	void ReturnToPool();
+
+	/**
+	 * Plays the impact and, on the server, applies the damage to OtherActor and ends the flight.
+	 * Returns false if the projectile passes through OtherActor: its damage causer, or a friend of its owner.
+	 */
+	bool HandleImpact(AActor* OtherActor);
+
+	/** The actor the projectile never hits, the effect causer of its damage spec. */
+	AActor* GetDamageCauser() const;
+
+	/** HitMode, unless Aura.Projectile.HitMode overrides it. Sweeps need Aura.ProjectileSimulation.Batched. */
+	EAuraProjectileHitMode GetHitMode() const;
+
+	/*
+	 * Client simulation.
+	 * A client simulated projectile is not replicated. The server multicasts a spawn event through its
+	 * AAuraCharacterBase instigator, clients fly a local proxy from it and only the hit is sent afterwards.
+	 */
+
+	bool IsClientSimulated() const { return bClientSimulated; }
+
+	/** Non zero for client simulated projectiles in flight, matches the server projectile to the client proxies. */
+	uint32 GetProjectileId() const { return ProjectileId; }
+	void SetProjectileId(uint32 InProjectileId) { ProjectileId = InProjectileId; }
+
+	/** Server: the event clients build their proxy from, once the projectile is launched. */
+	FAuraProjectileSpawnEvent MakeSpawnEvent() const;
+
+	/** Client: turns a locally spawned projectile into the proxy of SpawnEvent, before it is launched. */
+	void InitClientProxy(const FAuraProjectileSpawnEvent& SpawnEvent);
+
+	/** Client: the server projectile hit something at ImpactLocation. */
+	void HandleServerImpact(const FVector& ImpactLocation);
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void Destroyed() override;
-	
+	virtual void LifeSpanExpired() override;
+
 	UFUNCTION()
 	void OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
 private:
-	
+
 	bool bHit = false;
 
 	UPROPERTY(EditDefaultsOnly)
 	float LifeSpan = 15.f;
-	
+
+	/**
+	 * Sweep is opt-in: clients of sweeping projectiles get no overlap events, so their impact effects wait for the
+	 * server's return to the pool and play where the replicated projectile stopped.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Collision")
+	EAuraProjectileHitMode HitMode = EAuraProjectileHitMode::Overlap;
+
+	/** Where the current flight started, for the missed hit audit. */
+	FVector FlightStartLocation = FVector::ZeroVector;
+
+	/** Server: counts the flight as a missed hit if its path crosses something it does not pass through, see Aura.Projectile.AuditMissedHits. */
+	void AuditExpiredFlight() const;
+
+	/** Replace actor replication with a spawn event and a hit event, see MakeSpawnEvent. */
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	bool bClientSimulated = false;
+
+	uint32 ProjectileId = 0;
+
+	/** Local proxy of a client simulated projectile, never decides hits. */
+	bool bClientProxy = false;
+
 	UPROPERTY(VisibleAnywhere)
 	TObjectPtr<USphereComponent> Sphere;
 
@@ -55,8 +214,50 @@ private:
 	UPROPERTY()
 	TObjectPtr<UAudioComponent> LoopingSoundComponent;
 
+	/** The looping sound holds one of the UAuraImpactEffectsSubsystem looping sounds. */
+	bool bLoopingSoundBudgeted = false;
+
 	void ExecuteImpactEffects() const;
 
+	/** This projectile's context over the shared damage spec, see SetSharedDamageSpec. Invalid without one. */
+	FGameplayEffectContextHandle SharedDamageContextHandle;
+
+	/** Applies the shared spec with this projectile's context. */
+	void ApplySharedDamageSpec(UAbilitySystemComponent* TargetASC) const;
+
+	/** Plays the looping sound if the effects budget allows it. */
+	void StartLoopingSound();
+	void StopLoopingSound();
+
+	/* Pooling */
+	bool bPooled = false;
+
+	UPROPERTY(ReplicatedUsing = OnRep_PoolState)
+	FAuraProjectilePoolState PoolState;
+
+	/** Last PoolState.LaunchCount this machine started a flight for. */
+	uint8 LocalLaunchCount = 0;
+
+	/** Visible and moving on this machine. */
+	bool bInFlight = false;
+
+	UFUNCTION()
+	void OnRep_PoolState();
+
+	void StartFlight(const FTransform& SpawnTransform);
+	void StopFlight();
+
+	/** Seconds since ServerTime on the server clock, clamped to the life span. */
+	float GetElapsedServerTime(float ServerTime) const;
+
+	/* Batched simulation, see UAuraProjectileSimulationSubsystem */
+	friend class UAuraProjectileSimulationSubsystem;
+
+	/** Index in the simulation arrays, INDEX_NONE when not simulated. */
+	int32 SimulationIndex = INDEX_NONE;
 
+	/** Server: hands the movement and collision over to the simulation, if it is enabled. */
+	void StartSimulation();
+	void StopSimulation();
 
 };
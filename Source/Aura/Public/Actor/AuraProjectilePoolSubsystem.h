@@ -0,0 +1,76 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraProjectilePoolSubsystem.generated.h"
+
+class AAuraProjectile;
+struct FAuraProjectileSpawnEvent;
+
+USTRUCT()
+struct FAuraProjectilePool
+{
+	GENERATED_BODY()
+
+	/** Projectiles waiting to be launched again, hidden and net dormant. */
+	UPROPERTY()
+	TArray<TObjectPtr<AAuraProjectile>> Dormant;
+};
+
+/**
+ * Per class pools of AAuraProjectile, so sustained fire reuses actors instead of spawning and destroying them.
+ * Replicated projectiles are pooled on the server, clients follow the replicated pool state of each projectile.
+ * Clients pool the local proxies of client simulated projectiles.
+ */
+UCLASS()
+class AURA_API UAuraProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * Returns a dormant projectile of ProjectileClass, or a deferred spawn if the pool is empty.
+	 * Set up the projectile, then pass it to LaunchProjectile.
+	 */
+	AAuraProjectile* AcquireProjectile(TSubclassOf<AAuraProjectile> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator);
+
+	/** Finishes the spawn of a new projectile, or puts a reused one back in flight. */
+	void LaunchProjectile(AAuraProjectile* Projectile, const FTransform& SpawnTransform);
+
+	/** Called by AAuraProjectile::ReturnToPool. */
+	void ReleaseProjectile(AAuraProjectile* Projectile);
+
+	/** Tops the pool of ProjectileClass up to Count dormant projectiles. */
+	UFUNCTION(BlueprintCallable, Category = "Projectile")
+	void PrewarmProjectiles(TSubclassOf<AAuraProjectile> ProjectileClass, int32 Count);
+
+	/* Client simulated projectiles */
+
+	/** Server: a new id for a client simulated projectile. */
+	uint32 GenerateProjectileId();
+
+	/** Client: launches a local proxy for SpawnEvent. */
+	void SpawnClientProjectile(const FAuraProjectileSpawnEvent& SpawnEvent);
+
+	/** Client: ends the flight of the proxy of ProjectileId, if it is still flying. */
+	void ImpactClientProjectile(uint32 ProjectileId, const FVector& ImpactLocation);
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	UPROPERTY()
+	TMap<TSubclassOf<AAuraProjectile>, FAuraProjectilePool> Pools;
+
+	/** Client: proxies in flight by projectile id. */
+	TMap<uint32, TWeakObjectPtr<AAuraProjectile>> ClientProjectiles;
+
+	uint32 LastProjectileId = 0;
+
+	AAuraProjectile* SpawnPooledProjectile(TSubclassOf<AAuraProjectile> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator);
+};
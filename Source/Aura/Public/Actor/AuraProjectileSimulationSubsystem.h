@@ -0,0 +1,66 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraProjectileSimulationSubsystem.generated.h"
+
+class AAuraProjectile;
+
+/**
+ * Moves every server side AAuraProjectile in one batched step instead of one UProjectileMovementComponent tick per
+ * projectile. State is kept in struct-of-arrays form and integrated in parallel.
+ * - Sweep hit mode: one sphere sweep per projectile and step runs against ECC_Combat, in parallel, and hits go
+ *   through AAuraProjectile::HandleImpact, the same path the overlap uses.
+ * - Overlap hit mode: the actor is moved with a sweep of its own sphere, which only overlaps, so it keeps its overlap
+ *   events. Only the movement tick is saved.
+ * The actors only follow the simulation.
+ */
+UCLASS()
+class AURA_API UAuraProjectileSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Whether projectiles of this world should register, see Aura.ProjectileSimulation.Batched. */
+	static bool IsEnabled();
+
+	/** Starts simulating Projectile from its current location and the velocity of its movement component. */
+	void AddProjectile(AAuraProjectile* Projectile);
+
+	/** Stops simulating Projectile, if it was. */
+	void RemoveProjectile(AAuraProjectile* Projectile);
+
+	int32 GetNumProjectiles() const { return Projectiles.Num(); }
+
+	/* UTickableWorldSubsystem */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+
+	void RemoveAtSwap(int32 Index);
+
+	/* Parallel arrays, one entry per simulated projectile */
+	TArray<TWeakObjectPtr<AAuraProjectile>> Projectiles;
+	/** The damage causer, then whatever the projectile passed through. */
+	TArray<TArray<TWeakObjectPtr<AActor>, TInlineAllocator<2>>> IgnoredActors;
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<float> Radii;
+	TArray<float> GravityZ;
+	/** Sweep hit mode, ECC_Combat sweeps instead of overlap events. */
+	TArray<bool> SweepForHits;
+
+	/* Scratch, reused every step */
+	TArray<FCollisionQueryParams> QueryParams;
+	TArray<FHitResult> Hits;
+	TArray<TPair<TWeakObjectPtr<AAuraProjectile>, FVector>> Moves;
+	TArray<TPair<TWeakObjectPtr<AAuraProjectile>, TWeakObjectPtr<AActor>>> Impacts;
+};
@@ -4,6 +4,22 @@
 #include "GameplayEffectTypes.h"
 #include "AuraAbilityTypes.generated.h"
 
+/** Counters of the FAuraGameplayEffectContext pool. */
+struct FAuraEffectContextPoolStats
+{
+	/** Contexts currently alive. */
+	int64 Live = 0;
+
+	/** Most contexts alive at once. */
+	int64 Peak = 0;
+
+	/** Contexts allocated since startup. */
+	int64 Allocations = 0;
+
+	/** Allocations served by a recycled block instead of the heap. */
+	int64 AllocationsAvoided = 0;
+};
+
 USTRUCT(BlueprintType)
 struct FAuraGameplayEffectContext : public FGameplayEffectContext
 {
@@ -16,6 +32,21 @@ public:
 
 	void SetIsBlockedHit(bool bInIsBlockedHit) { bIsBlockedHit = bInIsBlockedHit; }
 	void SetIsCriticalHit(bool bInIsCriticalHit) { bIsCriticalHit = bInIsCriticalHit; }
+
+	/**
+	 * Index of the Block / Critical rolls of an execution that had no prediction key (see AuraDamageRandom).
+	 * Set by the server and replicated, so clients derive the same rolls. 0 for predicted executions.
+	 */
+	uint32 GetDamageRollIndex() const { return DamageRollIndex; }
+	void SetDamageRollIndex(uint32 InDamageRollIndex) { DamageRollIndex = InDamageRollIndex; }
+
+	/**
+	 * Compact hit result mode: NetSerialize only sends the hit location, quantized to 0.1cm, plus the normal and the hit
+	 * actor when they are set, instead of the whole FHitResult. For hit results that only carry a location, such as the
+	 * projectile spells' target location.
+	 */
+	bool UsesCompactHitResult() const { return bUseCompactHitResult; }
+	void SetUseCompactHitResult(bool bInUseCompactHitResult) { bUseCompactHitResult = bInUseCompactHitResult; }
 	
 	/** Returns the actual struct used for serialization, subclasses must override this! */
 	virtual UScriptStruct* GetScriptStruct() const override
@@ -39,13 +70,33 @@ public:
 	/** Custom serialization, subclasses must override this */
 	virtual bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
+	/*
+	 * Pooled allocation: every MakeEffectContext allocates a context, so they come from a lock-free free list and go
+	 * back to it when the last FGameplayEffectContextHandle releases them. Subclasses of a different size use the heap.
+	 */
+	static void* operator new(size_t Size);
+	static void operator delete(void* Ptr, size_t Size);
+	static void* operator new(size_t Size, void* Placement) { return Placement; }
+	static void operator delete(void* Ptr, void* Placement) {}
+
+	static FAuraEffectContextPoolStats GetPoolStats();
+
 protected:
+
+	/** Location, then the normal and the hit actor if set. Object references go through the archive's package map. */
+	bool NetSerializeCompactHitResult(FArchive& Ar);
 	
 	UPROPERTY()
 	bool bIsBlockedHit = false;
 
 	UPROPERTY()
 	bool bIsCriticalHit = false;
+
+	UPROPERTY()
+	bool bUseCompactHitResult = false;
+
+	UPROPERTY()
+	uint32 DamageRollIndex = 0;
 };
 
 template<>
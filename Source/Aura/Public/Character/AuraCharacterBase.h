@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "AbilitySystemInterface.h"
+#include "Actor/AuraProjectile.h"
 #include "GameFramework/Character.h"
 #include "Interaction/CombatInterface.h"
 #include "AuraCharacterBase.generated.h"
@@ -30,11 +31,20 @@ public:
 	virtual FVector GetCombatSocketLocation_Implementation() override;
 	virtual bool IsDead_Implementation() const override;
 	virtual AActor* GetAvatar_Implementation() override;
+	virtual EAuraTeam GetTeam() const override { return static_cast<EAuraTeam>(Team); }
 	/* end Combat Interface */
 	
 	UFUNCTION(NetMulticast, Reliable)
 	virtual void MulticastHandleDeath();
 
+	/* Client simulated projectiles, see AAuraProjectile::IsClientSimulated. Unreliable: a lost event only costs visuals */
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastSpawnProjectile(const FAuraProjectileSpawnEvent& SpawnEvent);
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastProjectileImpact(uint32 ProjectileId, FVector_NetQuantize ImpactLocation);
+
 protected:
 	virtual void BeginPlay() override;
 
@@ -44,6 +54,9 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Combat")
 	FName WeaponTipSocketName;
 
+	UPROPERTY(EditAnywhere, Category = "Combat", meta = (Bitmask, BitmaskEnum = "/Script/Aura.EAuraTeam"))
+	uint8 Team = 0;
+
 	bool bDead = false;
 	
 	UPROPERTY()
@@ -0,0 +1,27 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AuraBalanceSimulationCommandlet.generated.h"
+
+/**
+ * Monte Carlo duel simulator for balancing.
+ * Builds every ECharacterClass at every level through the real attribute pipeline (class Gameplay Effects, MMCs, primary attribute curves
+ * from <Project>/Data), then simulates duels between every pair of classes with the ExecCalc_Damage formula and its Block / Critical rolls.
+ * Duels run on all cores with ParallelFor. Writes win rates, time-to-kill and DPS distributions as JSON to Saved/Balance (or -Output=).
+ *
+ * UnrealEditor-Cmd Aura.uproject -run=AuraBalanceSimulation -nullrhi -unattended [-Duels=100000] [-MinLevel=1] [-MaxLevel=40]
+ *     [-Ability=Abilities.Firebolt] [-DamageType=Damage.Fire] [-AttackInterval=1.0] [-MaxHits=1000] [-Seed=0] [-Output=Path.json]
+ */
+UCLASS()
+class AURA_API UAuraBalanceSimulationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAuraBalanceSimulationCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
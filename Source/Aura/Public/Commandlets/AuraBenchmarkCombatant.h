@@ -0,0 +1,46 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AbilitySystemInterface.h"
+#include "GameFramework/Actor.h"
+#include "Interaction/CombatInterface.h"
+#include "AuraBenchmarkCombatant.generated.h"
+
+class UAbilitySystemComponent;
+class UAttributeSet;
+
+/**
+ * Bare combatant for headless tools: an Ability System Component, the Aura Attribute Set and a level.
+ * No mesh, no controller, no abilities.
+ */
+UCLASS(NotPlaceable, Transient)
+class AURA_API AAuraBenchmarkCombatant : public AActor, public IAbilitySystemInterface, public ICombatInterface
+{
+	GENERATED_BODY()
+
+public:
+	AAuraBenchmarkCombatant();
+
+	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
+	UAttributeSet* GetAttributeSet() const { return AttributeSet; }
+
+	/* Combat Interface */
+	virtual int32 GetPlayerLevel() override;
+	virtual void Die() override {}
+	/* end Combat Interface */
+
+	/** Initializes the actor info of the Ability System Component. Call once after spawning. */
+	void InitAbilityActorInfo();
+
+	int32 Level = 1;
+
+protected:
+
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
+
+	UPROPERTY()
+	TObjectPtr<UAttributeSet> AttributeSet;
+};
@@ -0,0 +1,47 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UObject/CoreNet.h"
+#include "AuraDamageBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless micro-benchmarks of the damage pipeline: UExecCalc_Damage (direct, through GAS and batched), the damage kernel,
+ * the six attribute MMCs and FAuraGameplayEffectContext::NetSerialize.
+ * Runs on synthetic attribute sets and on the real curves in <Project>/Data. Reports the mean ns/op, the p50 and p99 of
+ * individually timed ops and heap allocations per op, and writes the results as JSON to Saved/Benchmarks (or -Output=).
+ *
+ * UnrealEditor-Cmd Aura.uproject -run=AuraDamageBenchmark -nullrhi -unattended [-Samples=200] [-OpsPerSample=256] [-Seed=1] [-Output=Path.json]
+ *
+ * This runs in the editor binary, not in a Linux server build: the project has no server target. Absolute numbers
+ * include the editor build's overhead, so compare them between runs of the same binary.
+ */
+UCLASS()
+class AURA_API UAuraDamageBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAuraDamageBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
+
+/**
+ * Package map resolving objects to indices in a local table, so NetSerialize can run without a net driver.
+ */
+UCLASS(Transient)
+class AURA_API UAuraBenchmarkPackageMap : public UPackageMap
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID = nullptr) override;
+
+private:
+
+	UPROPERTY()
+	TArray<TObjectPtr<UObject>> Objects;
+};
@@ -0,0 +1,39 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * AuraAllocationCounter
+ *
+ * Debug helper that counts heap allocations going through GMalloc, per thread.
+ * Enable() installs a thin counting proxy over GMalloc (once, never removed). It is called automatically when the
+ * game runs with -AuraTrackAllocations, and can be called directly by tools such as benchmarks.
+ * Compiled out of Shipping builds: counts are always 0 there.
+ */
+namespace AuraAllocationCounter
+{
+	/** Installs the counting GMalloc proxy. Safe to call more than once. */
+	AURA_API void Enable();
+
+	/** True once the counting proxy is installed. */
+	AURA_API bool IsEnabled();
+
+	/** Total number of allocations made by the calling thread since the proxy was installed. */
+	AURA_API uint64 GetThreadAllocationCount();
+}
+
+/**
+ * Counts the heap allocations made by the current thread while this object is in scope.
+ */
+class AURA_API FAuraScopedAllocationCounter
+{
+public:
+	FAuraScopedAllocationCounter();
+
+	uint64 GetNumAllocations() const;
+
+private:
+	uint64 StartCount = 0;
+};
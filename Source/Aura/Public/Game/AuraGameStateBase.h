@@ -0,0 +1,29 @@
+// Giorjorio Copyright
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "AuraGameStateBase.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class AURA_API AAuraGameStateBase : public AGameStateBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostInitializeComponents() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+private:
+
+	/** Seed of the Block / Critical rolls for this match (AuraDamageRandom). Drawn by the server. */
+	UPROPERTY(ReplicatedUsing = OnRep_DamageRandomSeed)
+	uint32 DamageRandomSeed = 0;
+
+	UFUNCTION()
+	void OnRep_DamageRandomSeed();
+};
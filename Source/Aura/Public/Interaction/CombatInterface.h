@@ -6,6 +6,17 @@
 #include "UObject/Interface.h"
 #include "CombatInterface.generated.h"
 
+/** Teams a combatant belongs to, as bits. Two combatants sharing a bit are friends. */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EAuraTeam : uint8
+{
+	None = 0 UMETA(Hidden),
+	Players = 1 << 0,
+	Enemies = 1 << 1,
+	Neutral = 1 << 2
+};
+ENUM_CLASS_FLAGS(EAuraTeam);
+
 // This class does not need to be modified.
 UINTERFACE(MinimalAPI, BlueprintType)
 class UCombatInterface : public UInterface
@@ -27,6 +38,14 @@ public:
 
 	virtual int32 GetPlayerLevel();
 
+	virtual EAuraTeam GetTeam() const { return EAuraTeam::None; }
+
+	/** Team of Actor, None if it is not a combatant. */
+	static EAuraTeam GetActorTeam(const AActor* Actor);
+
+	/** Whether A and B share a team. */
+	static bool IsFriendly(const AActor* A, const AActor* B) { return EnumHasAnyFlags(GetActorTeam(A), GetActorTeam(B)); }
+
 
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
 	FVector GetCombatSocketLocation();
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
+#include "AI/Navigation/NavigationTypes.h"
 #include "GameFramework/PlayerController.h"
 #include "AuraPlayerController.generated.h"
 
@@ -33,6 +34,16 @@ public:
 	UFUNCTION(Client, Reliable)
 	void ShowDamageNumber(float DamageAmount, ACharacter* TargetCharacter, bool bBlockedHit, bool bCriticalHit);
 
+	/**
+	 * Hit under the cursor, shared by highlighting, click to move and ability targeting.
+	 * Traced at most CursorTraceRate times a second while the cursor or the camera moves, IdleCursorTraceRate times
+	 * otherwise. bCurrentFrame traces now unless this frame already did.
+	 */
+	const FHitResult& GetCursorHit(bool bCurrentFrame = false);
+
+	/** GFrameCounter of the last cursor trace. */
+	uint64 GetCursorHitFrame() const { return CursorHitFrame; }
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void SetupInputComponent() override;
@@ -46,6 +57,25 @@ private:
 	FHitResult CursorHit;
 
 	void CursorTrace();
+
+	/** Traces if the cursor trace is due, or now with bForce. Returns whether it traced. */
+	bool UpdateCursorHit(bool bForce);
+
+	/** Cursor traces per second while the cursor or the camera moves, 0 for every frame. */
+	UPROPERTY(EditDefaultsOnly, Category = "Cursor")
+	float CursorTraceRate = 60.f;
+
+	/** Cursor traces per second while nothing moves, to catch actors moving under the cursor. */
+	UPROPERTY(EditDefaultsOnly, Category = "Cursor")
+	float IdleCursorTraceRate = 10.f;
+
+	uint64 CursorHitFrame = 0;
+	double CursorHitTime = 0.0;
+	/** CursorHitFrame of the hit CursorTrace last highlighted from. */
+	uint64 HighlightedCursorHitFrame = 0;
+	FVector2D CursorTracePosition = FVector2D::ZeroVector;
+	FVector CursorTraceCameraLocation = FVector::ZeroVector;
+	FRotator CursorTraceCameraRotation = FRotator::ZeroRotator;
 	
 	TScriptInterface<IEnemyInterface> LastActor;
 	TScriptInterface<IEnemyInterface> ThisActor;
@@ -103,6 +133,21 @@ private:
 
 	void AutoRun();
 
+	/**
+	 * Async path query of the last short click, INVALID_NAVQUERYID if none is in flight. A new click aborts it, the
+	 * pawn runs straight toward CachedDestination until the path comes back.
+	 */
+	uint32 PathQueryId = INVALID_NAVQUERYID;
+	double PathQueryStartTime = 0.0;
+
+	/** Exponential moving average of the path query latency, for STAT_AuraPathLatency. */
+	double PathLatencyAverageMs = 0.0;
+	uint32 NumPathLatencySamples = 0;
+
+	void RequestPathToDestination(const APawn* ControlledPawn);
+	void AbortPathRequest();
+	void OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
 	/*
 	 * Show Damage Number
 	 */
@@ -28,6 +28,8 @@ public:
 
 	FORCEINLINE int32 GetPlayerLevel() const { return Level; }
 
+	/** Server: sets the level, dropping what was cached for the previous one. */
+	void SetPlayerLevel(int32 InLevel);
 
 
 protected: